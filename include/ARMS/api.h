@@ -2,7 +2,11 @@
 
 #include "ARMS/chassis.h"
 #include "ARMS/flags.h"
+#include "ARMS/gainSchedule.h"
+#include "ARMS/geometry.h"
 #include "ARMS/odom.h"
+#include "ARMS/odomMath.h"
 #include "ARMS/pid.h"
+#include "ARMS/pidController.h"
 #include "ARMS/point.h"
 #include "ARMS/selector.h"
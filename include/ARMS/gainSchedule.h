@@ -0,0 +1,193 @@
+#ifndef _ARMS_GAIN_SCHEDULE_H_
+#define _ARMS_GAIN_SCHEDULE_H_
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+
+namespace arms::pid {
+
+/**
+ * A set of PID gains
+ */
+struct Gains {
+	double kP;
+	double kI;
+	double kD;
+};
+
+inline Gains lerp(const Gains& a, const Gains& b, double t) {
+	return {a.kP + (b.kP - a.kP) * t, a.kI + (b.kI - a.kI) * t,
+	        a.kD + (b.kD - a.kD) * t};
+}
+
+/**
+ * A table of gains indexed by error magnitude (or remaining distance). Gains
+ * are linearly interpolated between rows and held constant past either end of
+ * the table. Rows must be given in ascending order of error.
+ *
+ * A schedule with a single row behaves exactly like constant gains.
+ */
+class GainSchedule {
+public:
+	static constexpr std::size_t MAX_ROWS = 8;
+
+	struct Row {
+		double error;
+		Gains gains;
+	};
+
+	GainSchedule() = default;
+
+	GainSchedule(Gains gains) : count(1) {
+		rows[0] = {0, gains};
+	}
+
+	/**
+	 * A schedule from at most MAX_ROWS rows in ascending order of error
+	 */
+	GainSchedule(std::initializer_list<Row> table) {
+		assert(table.size() <= MAX_ROWS && "GainSchedule has too many rows");
+		for (const Row& row : table) {
+			if (count == MAX_ROWS)
+				break;
+			assert((count == 0 || rows[count - 1].error <= row.error) &&
+			       "GainSchedule rows must be in ascending order of error");
+			rows[count++] = row;
+		}
+	}
+
+	/**
+	 * Return the interpolated gains for an error of the given magnitude
+	 */
+	Gains operator()(double error) const {
+		if (count == 0)
+			return {0, 0, 0};
+
+		error = std::fabs(error);
+		if (error <= rows[0].error)
+			return rows[0].gains;
+
+		for (std::size_t i = 1; i < count; i++) {
+			if (error < rows[i].error) {
+				const Row& lo = rows[i - 1];
+				const Row& hi = rows[i];
+				return lerp(lo.gains, hi.gains,
+				            (error - lo.error) / (hi.error - lo.error));
+			}
+		}
+
+		return rows[count - 1].gains;
+	}
+
+	std::size_t size() const {
+		return count;
+	}
+
+private:
+	std::array<Row, MAX_ROWS> rows{};
+	std::size_t count = 0;
+};
+
+/**
+ * Behaviour switches for a PID term
+ */
+struct PidOptions {
+	// only accumulate integral while |error| is inside this range
+	double windupRange = INFINITY;
+	// largest magnitude the integral term (kI * integral) may contribute
+	double integralLimit = INFINITY;
+	// clear the integral when the error changes sign
+	bool resetOnCross = true;
+	// take the derivative of the measurement instead of the error, which
+	// removes the derivative kick when the target jumps
+	bool derivativeOnMeasurement = false;
+};
+
+/**
+ * One PID term with scheduled gains. Like the ARMS controllers it works in
+ * units per control tick, so it does not need a time step. The term holds its
+ * own state and steps in constant time without allocating.
+ */
+class Pid {
+public:
+	Pid() = default;
+
+	Pid(GainSchedule schedule, PidOptions options = {})
+	    : schedule(schedule), options(options) {
+	}
+
+	/**
+	 * Run one step of the controller. measurement is only needed for
+	 * derivative-on-measurement, and index selects the row of the gain
+	 * schedule (|error| when not given). The derivative of the error is used
+	 * for any step where this or the previous measurement is missing.
+	 */
+	double step(double error, double measurement = NAN, double index = NAN) {
+		Gains g = schedule(std::isnan(index) ? error : index);
+
+		if (options.resetOnCross && ((prevError > 0 && error < 0) ||
+		                             (prevError < 0 && error > 0)))
+			in = 0;
+
+		double derivative = 0;
+		if (!first) {
+			if (options.derivativeOnMeasurement && measured &&
+			    std::isfinite(measurement))
+				derivative = prevMeasurement - measurement;
+			else
+				derivative = error - prevError;
+		}
+
+		if (std::fabs(error) < options.windupRange)
+			in += error;
+
+		// anti-windup: clamp the integral contribution and back-calculate the
+		// accumulator so it recovers as soon as the error allows
+		double iTerm = in * g.kI;
+		if (std::fabs(iTerm) > options.integralLimit) {
+			iTerm = std::copysign(options.integralLimit, iTerm);
+			in = iTerm / g.kI;
+		}
+
+		prevError = error;
+		measured = std::isfinite(measurement);
+		if (measured)
+			prevMeasurement = measurement;
+		first = false;
+
+		return error * g.kP + iTerm + derivative * g.kD;
+	}
+
+	/**
+	 * Clear the integral and derivative history
+	 */
+	void reset() {
+		in = 0;
+		prevError = 0;
+		prevMeasurement = 0;
+		measured = false;
+		first = true;
+	}
+
+	double integral() const {
+		return in;
+	}
+
+	GainSchedule schedule;
+	PidOptions options;
+
+private:
+	double in = 0;
+	double prevError = 0;
+	double prevMeasurement = 0;
+	// whether the previous step had a measurement
+	bool measured = false;
+	bool first = true;
+};
+
+} // namespace arms::pid
+
+#endif
@@ -0,0 +1,225 @@
+#ifndef _ARMS_GEOMETRY_H_
+#define _ARMS_GEOMETRY_H_
+
+#include "ARMS/point.h"
+#include <cmath>
+
+namespace arms {
+
+/**
+ * Value types for 2d geometry. Everything that does not need a transcendental
+ * function is constexpr. Rotations keep their cosine and sine instead of an
+ * angle, so composing, inverting and applying them is plain arithmetic.
+ *
+ * Float and double instantiations are provided as Vec2f/Vec2d and so on.
+ */
+template <typename T> struct Vec2 {
+	T x = 0;
+	T y = 0;
+
+	constexpr Vec2() = default;
+	constexpr Vec2(T x, T y) : x(x), y(y) {
+	}
+	constexpr explicit Vec2(const Point& p) : x(T(p.x)), y(T(p.y)) {
+	}
+
+	constexpr operator Point() const {
+		return {double(x), double(y)};
+	}
+
+	constexpr Vec2 operator-() const {
+		return {-x, -y};
+	}
+	constexpr Vec2 operator+(const Vec2& o) const {
+		return {x + o.x, y + o.y};
+	}
+	constexpr Vec2 operator-(const Vec2& o) const {
+		return {x - o.x, y - o.y};
+	}
+	constexpr Vec2 operator*(T s) const {
+		return {x * s, y * s};
+	}
+	constexpr Vec2 operator/(T s) const {
+		return {x / s, y / s};
+	}
+	constexpr Vec2& operator+=(const Vec2& o) {
+		x += o.x, y += o.y;
+		return *this;
+	}
+	constexpr Vec2& operator-=(const Vec2& o) {
+		x -= o.x, y -= o.y;
+		return *this;
+	}
+
+	constexpr T dot(const Vec2& o) const {
+		return x * o.x + y * o.y;
+	}
+	constexpr T cross(const Vec2& o) const {
+		return x * o.y - y * o.x;
+	}
+	constexpr T length2() const {
+		return x * x + y * y;
+	}
+	T length() const {
+		return std::sqrt(length2());
+	}
+};
+
+template <typename T> constexpr Vec2<T> operator*(T s, const Vec2<T>& v) {
+	return v * s;
+}
+
+/**
+ * sin(x), cos(x), sin(x) / x, (1 - cos(x)) / x and (x / 2) / tan(x / 2) for
+ * small angles, from their Taylor series. Each is cut off where the next term
+ * is below double precision for |x| < 0.1, which covers every odometry or
+ * control step.
+ */
+namespace series {
+template <typename T> constexpr T sinc(T x2) {
+	return T(1) -
+	       x2 / T(6) * (T(1) - x2 / T(20) * (T(1) - x2 / T(42) * (T(1) - x2 / T(72))));
+}
+template <typename T> constexpr T cosc(T x, T x2) {
+	return x / T(2) *
+	       (T(1) -
+	        x2 / T(12) * (T(1) - x2 / T(30) * (T(1) - x2 / T(56) * (T(1) - x2 / T(90)))));
+}
+template <typename T> constexpr T cos(T x2) {
+	return T(1) -
+	       x2 / T(2) * (T(1) - x2 / T(12) * (T(1) - x2 / T(30) * (T(1) - x2 / T(56))));
+}
+template <typename T> constexpr T halfCot(T x2) {
+	return T(1) -
+	       x2 / T(12) * (T(1) + x2 / T(60) * (T(1) + x2 / T(42) * (T(1) + x2 / T(40))));
+}
+template <typename T> constexpr bool small(T x2) {
+	return x2 < T(1e-2);
+}
+} // namespace series
+
+/**
+ * A rotation, stored as its cosine and sine
+ */
+template <typename T> struct Rot2 {
+	T c = 1;
+	T s = 0;
+
+	constexpr Rot2() = default;
+	constexpr Rot2(T c, T s) : c(c), s(s) {
+	}
+
+	/**
+	 * Rotation by an angle in radians. Small angles skip the library calls.
+	 */
+	static constexpr Rot2 fromAngle(T angle) {
+		T a2 = angle * angle;
+		if (series::small(a2))
+			return {series::cos(a2), angle * series::sinc(a2)};
+		return {std::cos(angle), std::sin(angle)};
+	}
+
+	T angle() const {
+		return std::atan2(s, c);
+	}
+
+	constexpr Rot2 operator*(const Rot2& o) const {
+		return {c * o.c - s * o.s, s * o.c + c * o.s};
+	}
+	constexpr Vec2<T> operator*(const Vec2<T>& v) const {
+		return {c * v.x - s * v.y, s * v.x + c * v.y};
+	}
+	constexpr Rot2 inverse() const {
+		return {c, -s};
+	}
+
+	/**
+	 * Pull the rotation back onto the unit circle after many compositions,
+	 * with one Newton step instead of a square root
+	 */
+	constexpr Rot2 normalized() const {
+		T k = (T(3) - (c * c + s * s)) / T(2);
+		return {c * k, s * k};
+	}
+};
+
+/**
+ * A velocity (or a displacement over one step) in the body frame
+ */
+template <typename T> struct Twist2 {
+	T dx = 0;
+	T dy = 0;
+	T dtheta = 0;
+};
+
+/**
+ * A rigid transform: rotate, then translate
+ */
+template <typename T> struct Pose2 {
+	Vec2<T> t;
+	Rot2<T> r;
+
+	constexpr Pose2() = default;
+	constexpr Pose2(Vec2<T> t, Rot2<T> r) : t(t), r(r) {
+	}
+
+	constexpr Pose2 operator*(const Pose2& o) const {
+		return {t + r * o.t, r * o.r};
+	}
+	constexpr Vec2<T> operator*(const Vec2<T>& v) const {
+		return t + r * v;
+	}
+	constexpr Pose2 inverse() const {
+		Rot2<T> ri = r.inverse();
+		return {-(ri * t), ri};
+	}
+
+	T heading() const {
+		return r.angle();
+	}
+
+	/**
+	 * The pose reached by following a constant twist for one unit of time
+	 * from the origin. Small heading changes need no library calls.
+	 */
+	static constexpr Pose2 exp(const Twist2<T>& v) {
+		T th = v.dtheta;
+		T th2 = th * th;
+		T a = 0;
+		T b = 0;
+		Rot2<T> r;
+		if (series::small(th2)) {
+			a = series::sinc(th2);
+			b = series::cosc(th, th2);
+			r = {series::cos(th2), th * a};
+		} else {
+			r = {std::cos(th), std::sin(th)};
+			a = r.s / th;
+			b = (T(1) - r.c) / th;
+		}
+		return {{a * v.dx - b * v.dy, b * v.dx + a * v.dy}, r};
+	}
+
+	/**
+	 * The twist that exp() maps to this pose
+	 */
+	Twist2<T> log() const {
+		T th = r.angle();
+		T half = th / T(2);
+		T a = series::small(th * th) ? series::halfCot(th * th) : half * r.s / (T(1) - r.c);
+		return {a * t.x + half * t.y, -half * t.x + a * t.y, th};
+	}
+};
+
+typedef Vec2<float> Vec2f;
+typedef Vec2<double> Vec2d;
+typedef Rot2<float> Rot2f;
+typedef Rot2<double> Rot2d;
+typedef Pose2<float> Pose2f;
+typedef Pose2<double> Pose2d;
+typedef Twist2<float> Twist2f;
+typedef Twist2<double> Twist2d;
+
+} // namespace arms
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef _ARMS_ODOM_MATH_H_
+#define _ARMS_ODOM_MATH_H_
+
+#include "ARMS/geometry.h"
+#include <cmath>
+
+namespace arms::odom {
+
+/**
+ * Scalar type used by the odometry kernel. Define ARMS_ODOM_FLOAT (for example
+ * with EXTRA_CXXFLAGS=-DARMS_ODOM_FLOAT in the Makefile) to use the single
+ * precision fast path instead of double precision.
+ */
+#ifdef ARMS_ODOM_FLOAT
+typedef float odom_float_t;
+#else
+typedef double odom_float_t;
+#endif
+
+/**
+ * A robot pose as tracked by the odometry kernel. The heading is in radians
+ * and (cos(theta), sin(theta)) points along the robot's forward direction.
+ */
+template <typename T> struct OdomPose {
+	T x;
+	T y;
+	T theta;
+};
+
+/**
+ * Return sin(x) / x. Odometry steps only ever see small angles, so those are
+ * evaluated with a short Taylor series instead of a division by a tiny number.
+ */
+template <typename T> inline T sinc(T x) {
+	T x2 = x * x;
+	if (x2 < T(1e-2))
+		return T(1) - x2 / T(6) * (T(1) - x2 / T(20) * (T(1) - x2 / T(42)));
+	return std::sin(x) / x;
+}
+
+/**
+ * Advance a pose along the constant curvature arc described by one odometry
+ * step. This is the exact SE(2) exponential map: the robot frame displacement
+ * is rotated to the heading halfway through the step and shortened from arc
+ * length to chord length by sinc(dtheta / 2).
+ *
+ * forward and lateral are the distances travelled in the robot frame and
+ * dtheta is the heading change over the step, in the same sense as theta.
+ */
+template <typename T>
+inline void arcStep(OdomPose<T>& pose, T forward, T lateral, T dtheta) {
+	T half = dtheta / T(2);
+	T k = sinc(half);
+	T a = pose.theta + half;
+	T c = std::cos(a);
+	T s = std::sin(a);
+	pose.x += k * (forward * c - lateral * s);
+	pose.y += k * (forward * s + lateral * c);
+	pose.theta += dtheta;
+}
+
+/**
+ * Advance a pose that caches its heading rotation by one odometry step. For
+ * the small heading change of a normal step no sin or cos is evaluated at all.
+ */
+template <typename T>
+inline void arcStep(Pose2<T>& pose, T forward, T lateral, T dtheta) {
+	pose = pose * Pose2<T>::exp({forward, lateral, dtheta});
+	pose.r = pose.r.normalized();
+}
+
+/**
+ * Advance a pose by one step of the left, right and middle tracking wheels.
+ * Heading increases when the right side travels further than the left, and
+ * middle_distance is how far the middle wheel sits behind the turning center.
+ */
+template <typename T>
+inline void arcStep(OdomPose<T>& pose, T left, T right, T middle,
+                    T track_width, T middle_distance) {
+	T dtheta = (right - left) / track_width;
+	arcStep(pose, (left + right) / T(2), middle + dtheta * middle_distance,
+	        dtheta);
+}
+
+} // namespace arms::odom
+
+#endif
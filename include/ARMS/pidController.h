@@ -0,0 +1,227 @@
+#ifndef _ARMS_PID_CONTROLLER_H_
+#define _ARMS_PID_CONTROLLER_H_
+
+#include "ARMS/gainSchedule.h"
+#include "ARMS/pid.h"
+#include "ARMS/point.h"
+#include <array>
+#include <cmath>
+
+// Declared as in ARMS/odom.h, which needs the PROS headers. They are only
+// linked in when the free functions below are called, so the controllers still
+// build on a host.
+namespace arms::odom {
+Point getPosition();
+double getHeading(bool radians);
+} // namespace arms::odom
+
+namespace arms::pid {
+
+/**
+ * Wrap an angle in degrees to [-180, 180)
+ */
+inline double wrapDegrees(double angle) {
+	angle = std::fmod(angle + 180, 360);
+	return angle < 0 ? angle + 180 : angle - 180;
+}
+
+// Integral windup range, in inches for moves and degrees for turns, matching the
+// |error| < 15 check in the ARMS pid() function these controllers replace
+constexpr double DEFAULT_WINDUP_RANGE = 15;
+
+/**
+ * Point tracking controller. Each instance holds its own target, flags and
+ * integral state, so any number of them can run side by side or be stepped on
+ * a host without the ARMS chassis task. A step runs in constant time and
+ * never allocates.
+ *
+ * Headings are in degrees and counterclockwise, like odom::getHeading().
+ */
+class TranslationalController {
+public:
+	TranslationalController() = default;
+
+	TranslationalController(GainSchedule linear, double trackingKP,
+	                        double minError, PidOptions options = {DEFAULT_WINDUP_RANGE})
+	    : linear(linear, options), trackingKP(trackingKP), minError(minError) {
+	}
+
+	/**
+	 * Build a controller from the gains and target currently held in the ARMS
+	 * globals, so code written against pid::init() keeps working unchanged
+	 */
+	static TranslationalController fromGlobals() {
+		TranslationalController c(Gains{linearKP, linearKI, linearKD},
+		                          pid::trackingKP, pid::minError);
+		c.target = pointTarget;
+		c.thru = pid::thru;
+		c.reverse = pid::reverse;
+		c.canReverse = pid::canReverse;
+		return c;
+	}
+
+	/**
+	 * Start a new movement. The move length picks the row of the gain schedule
+	 * for the whole movement.
+	 */
+	void setTarget(Point target, Point position, bool thru = false,
+	               bool reverse = false) {
+		this->target = target;
+		this->thru = thru;
+		this->reverse = reverse;
+		canReverse = false;
+		moveLength = std::hypot(target.x - position.x, target.y - position.y);
+		linear.reset();
+	}
+
+	/**
+	 * Return the {left, right} motor speeds for the current robot pose
+	 */
+	std::array<double, 2> step(Point position, double heading) {
+		double dx = target.x - position.x;
+		double dy = target.y - position.y;
+		double lin_error = std::hypot(dx, dy);
+		double ang_error =
+		    wrapDegrees(std::atan2(dy, dx) * 180 / M_PI - heading);
+
+		// drive backwards to the point
+		if (reverse) {
+			ang_error = wrapDegrees(ang_error + 180);
+			lin_error = -lin_error;
+		}
+
+		// once close to the point, allow overshoot to be corrected backwards
+		if (canReverse && std::fabs(ang_error) > 90) {
+			ang_error = wrapDegrees(ang_error + 180);
+			lin_error = -lin_error;
+		}
+
+		double lin_speed;
+		if (thru)
+			lin_speed = std::copysign(maxSpeed, lin_error);
+		else
+			lin_speed = linear.step(lin_error, NAN, moveLength);
+
+		if (lin_speed > maxSpeed)
+			lin_speed = maxSpeed;
+		else if (lin_speed < -maxSpeed)
+			lin_speed = -maxSpeed;
+
+		// stop steering when close to the point to prevent spinning
+		double ang_speed = 0;
+		if (std::fabs(lin_error) < minError)
+			canReverse = true;
+		else
+			ang_speed = ang_error * M_PI / 180 * trackingKP;
+
+		// limit both sides together so the robot keeps turning at the same rate
+		// relative to its speed
+		double left = lin_speed - ang_speed;
+		double right = lin_speed + ang_speed;
+		double fastest = std::fmax(std::fabs(left), std::fabs(right));
+		if (fastest > maxSpeed) {
+			left *= maxSpeed / fastest;
+			right *= maxSpeed / fastest;
+		}
+
+		return {left, right};
+	}
+
+	void reset() {
+		linear.reset();
+		canReverse = false;
+	}
+
+	Pid linear;
+	double trackingKP = 0;
+	double minError = 0;
+	double maxSpeed = 100;
+
+	Point target{0, 0};
+	bool thru = false;
+	bool reverse = false;
+	bool canReverse = false;
+
+private:
+	double moveLength = 0;
+};
+
+/**
+ * Turn-in-place controller, holding its own target and integral state.
+ * Headings are in degrees and counterclockwise, like odom::getHeading().
+ */
+class AngularController {
+public:
+	AngularController() = default;
+
+	AngularController(GainSchedule angular, PidOptions options = {DEFAULT_WINDUP_RANGE})
+	    : angular(angular, options) {
+	}
+
+	/**
+	 * Build a controller from the gains and target currently held in the ARMS
+	 * globals
+	 */
+	static AngularController fromGlobals() {
+		AngularController c(Gains{angularKP, angularKI, angularKD});
+		c.target = angularTarget;
+		return c;
+	}
+
+	/**
+	 * Start a new turn. The size of the turn picks the row of the gain
+	 * schedule for the whole movement.
+	 */
+	void setTarget(double target, double heading) {
+		this->target = target;
+		turnSize = std::fabs(target - heading);
+		angular.reset();
+	}
+
+	/**
+	 * Return the {left, right} motor speeds for the current heading
+	 */
+	std::array<double, 2> step(double heading) {
+		double speed = angular.step(target - heading, heading, turnSize);
+
+		if (speed > maxSpeed)
+			speed = maxSpeed;
+		else if (speed < -maxSpeed)
+			speed = -maxSpeed;
+
+		return {-speed, speed};
+	}
+
+	void reset() {
+		angular.reset();
+	}
+
+	Pid angular;
+	double maxSpeed = 100;
+	double target = 0;
+
+private:
+	double turnSize = 0;
+};
+
+/**
+ * Step a controller from the robot's odometry. Together with fromGlobals() this
+ * is a drop-in for the global controller:
+ *
+ *   auto c = pid::TranslationalController::fromGlobals();
+ *   auto speeds = pid::translational(c); // was pid::translational()
+ */
+inline std::array<double, 2> translational(TranslationalController& c) {
+	return c.step(odom::getPosition(), odom::getHeading(false));
+}
+
+/**
+ * Step a turn controller from the robot's odometry, like pid::angular()
+ */
+inline std::array<double, 2> angular(AngularController& c) {
+	return c.step(odom::getHeading(false));
+}
+
+} // namespace arms::pid
+
+#endif
@@ -17,42 +17,42 @@ namespace arms {
  * refer to the same variable.
  */
 union Point {
-	Point operator-() {
+	Point operator-() const {
 		return {-x, -y};
 	}
 
-	Point operator+(const Point& o) {
+	Point operator+(const Point& o) const {
 		return {x + o.x, y + o.y};
 	}
 
-	Point operator-(const Point& o) {
+	Point operator-(const Point& o) const {
 		return {x - o.x, y - o.y};
 	}
 
-	Point operator*(const Point& o) {
+	Point operator*(const Point& o) const {
 		return {x * o.x, y * o.y};
 	}
 
-	Point operator/(const Point& o) {
+	Point operator/(const Point& o) const {
 		return {x / o.x, y / o.y};
 	}
 
-	Point& operator+=(Point& o) {
+	Point& operator+=(const Point& o) {
 		x += o.x, y += o.y;
 		return *this;
 	}
 
-	Point& operator-=(Point& o) {
+	Point& operator-=(const Point& o) {
 		x -= o.x, y -= o.y;
 		return *this;
 	}
 
-	Point& operator*=(Point& o) {
+	Point& operator*=(const Point& o) {
 		x *= o.x, y *= o.y;
 		return *this;
 	}
 
-	Point& operator/=(Point& o) {
+	Point& operator/=(const Point& o) {
 		x /= o.x, y /= o.y;
 		return *this;
 	}
@@ -61,11 +61,15 @@ union Point {
 		return data[index];
 	}
 
+	double operator[](unsigned int index) const {
+		return data[index];
+	}
+
 	// This is a stop gap until the codebase is made to use Point for bot
 	// coordinates
 	//
 	//  TODO: Replace PID code to use this class
-	std::array<double, 2> std() {
+	std::array<double, 2> std() const {
 		return {x, y};
 	}
 
@@ -97,38 +101,22 @@ inline Point& operator/=(Point& v, double s) {
 	return v;
 }
 
-inline double dot(Point& a, Point& b) {
+inline double dot(const Point& a, const Point& b) {
 	return a.x * b.x + a.y * b.y;
 }
 
-inline double length2(Point& p) {
-	return p.x * p.x + p.y * p.y;
-}
-
-// Why does c++ have weird things like r-value references... ;_;
-inline double length2(Point&& p) {
+inline double length2(const Point& p) {
 	return p.x * p.x + p.y * p.y;
 }
 
-inline double length(Point& p) {
+inline double length(const Point& p) {
 	if (p.x == 0.0 && p.y == 0.0)
 		return 0.0;
 	else
 		return std::sqrt(p.x * p.x + p.y * p.y);
 }
 
-inline double length(Point&& p) {
-	if (p.x == 0.0 && p.y == 0.0)
-		return 0.0;
-	else
-		return std::sqrt(p.x * p.x + p.y * p.y);
-}
-
-inline Point normalize(Point& a) {
-	return a / length(a);
-}
-
-inline Point normalize(Point&& a) {
+inline Point normalize(const Point& a) {
 	return a / length(a);
 }
 
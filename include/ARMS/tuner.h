@@ -0,0 +1,322 @@
+#ifndef _ARMS_TUNER_H_
+#define _ARMS_TUNER_H_
+
+#include "ARMS/odomMath.h"
+#include "ARMS/pidController.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#ifdef THREADS_STD
+#include <thread>
+#endif
+
+namespace arms::tuner {
+
+/**
+ * A characterized tank drivetrain. Each side is a first order system from the
+ * commanded speed (percent) to wheel speed (inches per second), which is what
+ * a quasi-static/step-response characterization run measures.
+ */
+struct DrivetrainModel {
+	double maxSpeed = 50;      // wheel speed at 100% command, in/s
+	double timeConstant = 0.15; // 63% rise time of a wheel speed step, s
+	double deadband = 3;       // commands below this many % do not move the wheel
+	double trackWidth = 11.125; // in
+	double dt = 0.01;          // control period, s
+};
+
+/**
+ * Simulates a DrivetrainModel, integrating the pose with the exact arc update
+ */
+class DrivetrainSim {
+public:
+	DrivetrainSim(const DrivetrainModel& model) : model(model) {
+	}
+
+	void step(double left, double right) {
+		double a = model.dt / (model.timeConstant + model.dt);
+		vl += (target(left) - vl) * a;
+		vr += (target(right) - vr) * a;
+		odom::arcStep(pose, vl * model.dt, vr * model.dt, 0.0, model.trackWidth,
+		              0.0);
+	}
+
+	Point position() const {
+		return {pose.x, pose.y};
+	}
+
+	double heading() const {
+		return pose.theta * 180 / M_PI;
+	}
+
+private:
+	double target(double command) const {
+		if (std::fabs(command) < model.deadband)
+			return 0;
+		return std::clamp(command, -100.0, 100.0) / 100 * model.maxSpeed;
+	}
+
+	DrivetrainModel model;
+	odom::OdomPose<double> pose{0, 0, 0};
+	double vl = 0;
+	double vr = 0;
+};
+
+/**
+ * Cost of one set of gains. Uses the same terms as okapi::PIDTuner: the
+ * integral of time-weighted absolute error and the time taken to settle, in
+ * seconds.
+ */
+struct Score {
+	double itae = 0;
+	double settleTime = 0;
+	double cost = 0;
+};
+
+/**
+ * Particle swarm tuner for the ARMS controllers. Every particle is scored by
+ * simulating a set of moves against a DrivetrainModel, so tuning runs faster
+ * than real time and needs no robot. When built for the host with
+ * THREADS_STD, the particles of each iteration are scored in parallel on all
+ * cores. On the brain they are scored one after another.
+ */
+class Tuner {
+public:
+	struct Range {
+		double min;
+		double max;
+	};
+
+	struct Result {
+		pid::Gains gains;
+		Score score;
+	};
+
+	Tuner(DrivetrainModel model, Range kP, Range kI, Range kD)
+	    : model(model), ranges{kP, kI, kD} {
+	}
+
+	/**
+	 * Score gains for the translational controller over every move length
+	 */
+	Score scoreLinear(const pid::Gains& gains) const {
+		Score total;
+		for (double length : moves) {
+			pid::TranslationalController c(gains, trackingKP, minError);
+			DrivetrainSim sim(model);
+			c.setTarget({length, 0}, sim.position());
+			accumulate(total, [&] {
+				auto out = c.step(sim.position(), sim.heading());
+				sim.step(out[0], out[1]);
+				return length - sim.position().x;
+			});
+		}
+		total.cost = kSettle * total.settleTime + kITAE * total.itae;
+		return total;
+	}
+
+	/**
+	 * Score gains for the angular controller over every turn size
+	 */
+	Score scoreAngular(const pid::Gains& gains) const {
+		Score total;
+		for (double angle : turns) {
+			pid::AngularController c(gains);
+			DrivetrainSim sim(model);
+			c.setTarget(angle, sim.heading());
+			accumulate(total, [&] {
+				auto out = c.step(sim.heading());
+				sim.step(out[0], out[1]);
+				return angle - sim.heading();
+			});
+		}
+		total.cost = kSettle * total.settleTime + kITAE * total.itae;
+		return total;
+	}
+
+	/**
+	 * Tune the translational controller. A warning is printed to stderr for
+	 * every gain that ends on a bound of its range, see warnIfOnBound().
+	 */
+	Result tuneLinear() {
+		Result result =
+		    tune([this](const pid::Gains& g) { return scoreLinear(g); });
+		warnIfOnBound("linear", result.gains);
+		return result;
+	}
+
+	/**
+	 * Tune the angular controller, warning like tuneLinear()
+	 */
+	Result tuneAngular() {
+		Result result =
+		    tune([this](const pid::Gains& g) { return scoreAngular(g); });
+		warnIfOnBound("angular", result.gains);
+		return result;
+	}
+
+	/**
+	 * Format tuned gains as the matching lines of ARMS/config.h
+	 */
+	static std::string configLines(const pid::Gains& linear,
+	                               const pid::Gains& angular) {
+		return "#define LINEAR_KP " + std::to_string(linear.kP) + "\n" +
+		       "#define LINEAR_KI " + std::to_string(linear.kI) + "\n" +
+		       "#define LINEAR_KD " + std::to_string(linear.kD) + "\n" +
+		       "#define ANGULAR_KP " + std::to_string(angular.kP) + "\n" +
+		       "#define ANGULAR_KI " + std::to_string(angular.kI) + "\n" +
+		       "#define ANGULAR_KD " + std::to_string(angular.kD) + "\n";
+	}
+
+	// moves (in) and turns (deg) every particle is scored on
+	std::vector<double> moves{5, 12, 24, 40};
+	std::vector<double> turns{15, 45, 90, 180};
+
+	// settle window, matching the ARMS defaults
+	double settleError = 0.5;
+	double settleTime = 0.35;
+	double timeout = 4;
+
+	// controller constants that are not tuned
+	double trackingKP = 90;
+	double minError = 0.5;
+
+	std::size_t numIterations = 20;
+	std::size_t numParticles = 64;
+	double kSettle = 1;
+	double kITAE = 2;
+	unsigned seed = 1;
+
+	// particle swarm constants, the same as okapi::PIDTuner
+	static constexpr double inertia = 0.5;
+	static constexpr double confSelf = 1.1;
+	static constexpr double confSwarm = 1.2;
+
+private:
+	struct Particle {
+		double pos, vel, best;
+	};
+
+	struct ParticleSet {
+		std::array<Particle, 3> k;
+		double bestError;
+	};
+
+	/**
+	 * Run one simulated movement until it settles or times out. step advances
+	 * the simulation by one tick and returns the error.
+	 */
+	template <typename Step> void accumulate(Score& total, Step step) const {
+		double t = 0;
+		double settledFor = 0;
+		while (t < timeout && settledFor < settleTime) {
+			double error = std::fabs(step());
+			t += model.dt;
+			total.itae += t * error * model.dt;
+			settledFor = error < settleError ? settledFor + model.dt : 0;
+		}
+		total.settleTime += t;
+	}
+
+	/**
+	 * A gain that ends within 1% of an upper bound, or of a lower bound above
+	 * zero, was most likely cut off by the range rather than found by the
+	 * search. A gain of zero is a valid result, so that bound is not reported.
+	 */
+	void warnIfOnBound(const char* controller, const pid::Gains& gains) const {
+		static const char* const names[3] = {"kP", "kI", "kD"};
+		const double values[3] = {gains.kP, gains.kI, gains.kD};
+		for (std::size_t j = 0; j < 3; j++) {
+			const Range& r = ranges[j];
+			const double margin = (r.max - r.min) * 0.01;
+			const bool top = values[j] >= r.max - margin;
+			const bool bottom = r.min > 0 && values[j] <= r.min + margin;
+			if (top || bottom)
+				std::fprintf(stderr,
+				             "arms::tuner: %s %s = %g is at the %s of its range "
+				             "[%g, %g], widen it unless that is the intended limit\n",
+				             controller, names[j], values[j],
+				             top ? "top" : "bottom", r.min, r.max);
+		}
+	}
+
+	template <typename Cost> Result tune(Cost cost) {
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<double> unit(0, 1);
+
+		std::vector<ParticleSet> particles(numParticles);
+		for (ParticleSet& p : particles) {
+			for (std::size_t j = 0; j < 3; j++) {
+				double pos = ranges[j].min + unit(rng) * (ranges[j].max - ranges[j].min);
+				p.k[j] = {pos, 0, pos};
+			}
+			p.bestError = INFINITY;
+		}
+
+		Result best{{0, 0, 0}, {0, 0, INFINITY}};
+		std::vector<Score> scores(numParticles);
+
+		for (std::size_t iteration = 0; iteration < numIterations; iteration++) {
+			evaluate(particles, scores, cost);
+
+			for (std::size_t i = 0; i < numParticles; i++) {
+				ParticleSet& p = particles[i];
+				if (scores[i].cost < p.bestError) {
+					p.bestError = scores[i].cost;
+					for (Particle& k : p.k)
+						k.best = k.pos;
+				}
+				if (scores[i].cost < best.score.cost) {
+					best.score = scores[i];
+					best.gains = {p.k[0].pos, p.k[1].pos, p.k[2].pos};
+				}
+			}
+
+			const double global[3] = {best.gains.kP, best.gains.kI, best.gains.kD};
+			for (ParticleSet& p : particles) {
+				for (std::size_t j = 0; j < 3; j++) {
+					Particle& k = p.k[j];
+					k.vel = inertia * k.vel + confSelf * unit(rng) * (k.best - k.pos) +
+					        confSwarm * unit(rng) * (global[j] - k.pos);
+					k.pos = std::clamp(k.pos + k.vel, ranges[j].min, ranges[j].max);
+				}
+			}
+		}
+
+		return best;
+	}
+
+	template <typename Cost>
+	void evaluate(const std::vector<ParticleSet>& particles,
+	              std::vector<Score>& scores, Cost& cost) const {
+		auto run = [&](std::size_t begin, std::size_t stride) {
+			for (std::size_t i = begin; i < particles.size(); i += stride) {
+				const ParticleSet& p = particles[i];
+				scores[i] = cost(pid::Gains{p.k[0].pos, p.k[1].pos, p.k[2].pos});
+			}
+		};
+
+#ifdef THREADS_STD
+		std::size_t workers = std::max(1u, std::thread::hardware_concurrency());
+		std::vector<std::thread> threads;
+		for (std::size_t w = 0; w < workers; w++)
+			threads.emplace_back(run, w, workers);
+		for (std::thread& t : threads)
+			t.join();
+#else
+		run(0, 1);
+#endif
+	}
+
+	DrivetrainModel model;
+	std::array<Range, 3> ranges;
+};
+
+} // namespace arms::tuner
+
+#endif
@@ -0,0 +1,8 @@
+// Generated by tools/pathgen.cpp from tools/paths.def. Do not edit.
+// tools/paths.def cksum 2274522414 681
+#pragma once
+
+#include "okapi/squiggles/geometry/packedprofile.hpp"
+
+namespace paths {
+} // namespace paths
@@ -79,6 +79,71 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
                     const std::string &ipathId,
                     const PathfinderLimits &ilimits);
 
+  /**
+   * Same as `generatePath()`, but looks the path up in a cache first and only generates it if
+   * the same waypoints, limits and chassis width have never been generated before. Generated paths
+   * are added to the cache. If the cache has a directory on the SD card, paths found there are
+   * kept across reboots, and the path is loaded with the 16 bit rounding of the cache's files
+   * whether or not it was just generated.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ipathId A unique identifier to save the path with.
+   * @param icache The cache to look the path up in and add it to.
+   */
+  void generatePath(std::initializer_list<PathfinderPoint> iwaypoints,
+                    const std::string &ipathId,
+                    squiggles::PathCache &icache) {
+    generatePath(iwaypoints, ipathId, limits, icache);
+  }
+
+  /**
+   * Same as `generatePath()`, but looks the path up in a cache first and only generates it if
+   * the same waypoints, limits and chassis width have never been generated before. Generated paths
+   * are added to the cache. If the cache has a directory on the SD card, paths found there are
+   * kept across reboots, and the path is loaded with the 16 bit rounding of the cache's files
+   * whether or not it was just generated.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ipathId A unique identifier to save the path with.
+   * @param ilimits The limits to use for this path only.
+   * @param icache The cache to look the path up in and add it to.
+   */
+  void generatePath(std::initializer_list<PathfinderPoint> iwaypoints,
+                    const std::string &ipathId,
+                    const PathfinderLimits &ilimits,
+                    squiggles::PathCache &icache) {
+    // Everything generatePath's output depends on. The tag changes the key if the way paths are
+    // generated ever does.
+    squiggles::PathKey key;
+    key.add(std::string("AsyncMotionProfileController 1"))
+      .add(ilimits.maxVel)
+      .add(ilimits.maxAccel)
+      .add(ilimits.maxJerk)
+      .add(scales.wheelTrack.convert(meter));
+    for (const auto &point : iwaypoints) {
+      key.add(squiggles::Pose(
+        point.x.convert(meter), point.y.convert(meter), point.theta.convert(radian)));
+    }
+
+    // Load the path as the cache returns it, even when it was just generated, so it has the same
+    // rounding as the next time it comes from the cache
+    auto path = icache.get_or_generate(key, [&] {
+      generatePath(iwaypoints, ipathId, ilimits);
+      const auto found = paths.find(ipathId);
+      return found == paths.end() ? std::vector<squiggles::ProfilePoint>() : found->second;
+    });
+    if (path.empty()) {
+      return;
+    }
+
+    if (!removePath(ipathId)) {
+      LOG_WARN("AsyncMotionProfileController: Not loading path " + ipathId +
+               " because a path with that ID is running.");
+      return;
+    }
+    paths.emplace(ipathId, std::move(path));
+  }
+
   /**
    * Removes a path and frees the memory it used. This function returns true if the path was either
    * deleted or didn't exist in the first place. It returns false if the path could not be removed
@@ -256,6 +321,87 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
    */
   void loadPath(const std::string &idirectory, const std::string &ipathId);
 
+  /**
+   * Loads a path that was generated ahead of time (see `tools/pathgen.cpp`) from a read-only
+   * table. No path generation happens on the robot. If a path with the same ID is currently
+   * running, the table is not loaded.
+   *
+   * @param ipath The precompiled path, for example one of the tables in `generatedPaths.h`
+   * @param ipathId The path ID that the path will be loaded into
+   */
+  void loadPath(const squiggles::PackedPath &ipath, const std::string &ipathId) {
+    if (!removePath(ipathId)) {
+      LOG_WARN("AsyncMotionProfileController: Not loading path " + ipathId +
+               " because a path with that ID is running.");
+      return;
+    }
+
+    paths.emplace(ipathId, ipath.unpack());
+  }
+
+  /**
+   * Saves a generated path to a file in the compact binary format (see `squiggles/binaryio.hpp`).
+   * Paths are stored as `<ipathId>.bin`. An SD card must be inserted into the brain and the
+   * directory must exist. `idirectory` can be prefixed with `/usd/`, but it this is not required.
+   *
+   * @param idirectory The directory to store the path file in
+   * @param ipathId The path ID of the generated path
+   */
+  void storePathBinary(const std::string &idirectory, const std::string &ipathId) {
+    const auto path = paths.find(ipathId);
+    if (path == paths.end()) {
+      LOG_WARN("AsyncMotionProfileController: Controller was asked to serialize path " + ipathId +
+               " but no path with that ID exists.");
+      return;
+    }
+
+    const std::string filePath = makeFilePath(idirectory, ipathId + ".bin");
+    std::FILE *file = std::fopen(filePath.c_str(), "wb");
+    if (file == nullptr) {
+      LOG_ERROR("AsyncMotionProfileController: Couldn't open " + filePath + " for writing");
+      return;
+    }
+
+    if (squiggles::serialize_binary_path(file, path->second) != 0) {
+      LOG_ERROR("AsyncMotionProfileController: Failed to write path " + ipathId + " to " +
+                filePath);
+    }
+    std::fclose(file);
+  }
+
+  /**
+   * Loads a path from a binary file written by `storePathBinary` or `tools/pathconv.cpp`. `/usd/`
+   * is automatically prepended to `idirectory` if it is not specified. The file is read with one
+   * bulk read and rejected if its header or checksum do not match.
+   *
+   * @param idirectory The directory that the path files are stored in
+   * @param ipathId The path ID that the path is stored under (and will be loaded into)
+   */
+  void loadPathBinary(const std::string &idirectory, const std::string &ipathId) {
+    const std::string filePath = makeFilePath(idirectory, ipathId + ".bin");
+    std::FILE *file = std::fopen(filePath.c_str(), "rb");
+    if (file == nullptr) {
+      LOG_ERROR("AsyncMotionProfileController: Couldn't open " + filePath + " for reading");
+      return;
+    }
+
+    auto path = squiggles::deserialize_binary_path(file);
+    std::fclose(file);
+    if (!path) {
+      LOG_ERROR("AsyncMotionProfileController: Path file " + filePath +
+                " is not a valid binary path");
+      return;
+    }
+
+    if (!removePath(ipathId)) {
+      LOG_WARN("AsyncMotionProfileController: Not loading path " + ipathId +
+               " because a path with that ID is running.");
+      return;
+    }
+
+    paths.emplace(ipathId, std::move(*path));
+  }
+
   /**
    * Attempts to remove a path without stopping execution. If that fails, disables the controller
    * and removes the path.
@@ -0,0 +1,635 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/async/asyncMotionProfileController.hpp"
+#include "okapi/api/control/util/ramsete.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/odometry/odometry.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <memory>
+#ifdef THREADS_STD
+#include <chrono>
+#endif
+
+namespace okapi {
+class AsyncRamseteMotionProfileController : public AsyncMotionProfileController {
+  public:
+  /**
+   * Returns the robot's pose in meters and radians, with +x forward, +y to the left and yaw
+   * counterclockwise. This is the frame the generated wheel velocities drive in: squiggles turns
+   * towards +y by speeding up the right side. It is okapi's `StateMode::FRAME_TRANSFORMATION`
+   * with y and theta negated, and the frame of `arms::odom`.
+   */
+  using PoseSource = std::function<squiggles::Pose()>;
+
+  /**
+   * An AsyncMotionProfileController which closes the loop around its paths. The profile's wheel
+   * velocities are still the feedforward, and on each 10 ms tick a RAMSETE correction computed
+   * from the robot's measured pose is added to them. Without a correction, a bump or wheel slip
+   * leaves the robot off the path for the rest of it. With the correction, the robot is steered
+   * back onto it.
+   *
+   * Paths are followed relative to the pose the robot is at when they start, like the base
+   * controller does, so the pose source does not need to be reset before each path. Backwards and
+   * mirrored paths are tracked too.
+   *
+   * Unlike the base controller, this is not made by a builder. Call `startThread()` after
+   * constructing it.
+   *
+   * @param itimeUtil The TimeUtil.
+   * @param ilimits The default limits.
+   * @param imodel The chassis model to control.
+   * @param iscales The chassis dimensions.
+   * @param ipair The gearset.
+   * @param iposeSource Where to read the robot's pose from, for example a lambda wrapping
+   * `arms::odom::getPosition()` and `arms::odom::getHeading(true)`, converted to meters.
+   * @param igains The RAMSETE tuning.
+   * @param ilogger The logger this instance will log to.
+   */
+  AsyncRamseteMotionProfileController(const TimeUtil &itimeUtil,
+                                      const PathfinderLimits &ilimits,
+                                      const std::shared_ptr<ChassisModel> &imodel,
+                                      const ChassisScales &iscales,
+                                      const AbstractMotor::GearsetRatioPair &ipair,
+                                      PoseSource iposeSource,
+                                      const RamseteGains &igains = RamseteGains(),
+                                      const std::shared_ptr<Logger> &ilogger =
+                                        Logger::getDefaultLogger())
+    : AsyncMotionProfileController(itimeUtil, ilimits, imodel, iscales, ipair, ilogger),
+      poseSource(std::move(iposeSource)),
+      gains(igains) {
+  }
+
+  /**
+   * Same as above, reading the robot's pose from okapi odometry. The odometry must be stepped by
+   * its own task, such as an `OdomChassisController`'s.
+   *
+   * @param iodometry The odometry to read the robot's pose from.
+   */
+  AsyncRamseteMotionProfileController(const TimeUtil &itimeUtil,
+                                      const PathfinderLimits &ilimits,
+                                      const std::shared_ptr<ChassisModel> &imodel,
+                                      const ChassisScales &iscales,
+                                      const AbstractMotor::GearsetRatioPair &ipair,
+                                      const std::shared_ptr<Odometry> &iodometry,
+                                      const RamseteGains &igains = RamseteGains(),
+                                      const std::shared_ptr<Logger> &ilogger =
+                                        Logger::getDefaultLogger())
+    : AsyncRamseteMotionProfileController(
+        itimeUtil,
+        ilimits,
+        imodel,
+        iscales,
+        ipair,
+        [iodometry] {
+          // okapi's +y is to the right and its theta clockwise
+          const OdomState state = iodometry->getState(StateMode::FRAME_TRANSFORMATION);
+          return squiggles::Pose(
+            state.x.convert(meter), -state.y.convert(meter), -state.theta.convert(radian));
+        },
+        igains,
+        ilogger) {
+  }
+
+  /**
+   * Sets whether paths are followed closed loop. When this is off, paths are followed open loop
+   * with the same wheel velocities `AsyncMotionProfileController` sends. Takes effect at the start
+   * of the next path.
+   *
+   * @param iclosedLoop Whether to correct the robot's motion using its measured pose.
+   */
+  void setClosedLoop(const bool iclosedLoop) {
+    closedLoop.store(iclosedLoop, std::memory_order_release);
+  }
+
+  /**
+   * @return Whether paths are followed closed loop.
+   */
+  bool isClosedLoop() const {
+    return closedLoop.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Returns the tracking error from the last tick of closed loop following, in the robot's frame:
+   * `x` is how far the target is ahead of the robot, `y` how far it is to the right, and `theta`
+   * how far the robot must turn clockwise to face the target's heading, like okapi's odometry.
+   *
+   * @return the last error
+   */
+  PathfinderPoint getError() const override {
+    return {errorX.load(std::memory_order_acquire) * meter,
+            errorY.load(std::memory_order_acquire) * meter,
+            errorTheta.load(std::memory_order_acquire) * radian};
+  }
+
+  /**
+   * How well the executor kept to the profile's timing on a path.
+   */
+  struct TimingStats {
+    std::size_t ticks{0};          // Number of times the wheels were commanded
+    std::size_t overruns{0};       // Ticks that started more than half a period late
+    std::size_t skippedSamples{0}; // Profile points stepped over because of late ticks
+    QTime maxLateness{0_ms};       // The latest any tick started, beyond its period
+    QTime plannedDuration{0_ms};   // The profile's duration
+    QTime actualDuration{0_ms};    // The time from the first tick to the last
+  };
+
+  /**
+   * Returns the timing statistics of the last path followed, or of the current one so far.
+   *
+   * @return the timing statistics
+   */
+  TimingStats getTimingStats() const {
+    std::scoped_lock lock(statsMutex);
+    return stats;
+  }
+
+  /**
+   * Generates a path through the waypoints and follows it, starting to drive as soon as the first
+   * segment (between the first two waypoints) is ready instead of after the whole path is. The
+   * remaining segments are generated by a worker task while the robot drives and are appended to
+   * the path before it reaches them. Blocks until the path is finished. Paths are followed closed
+   * loop if that is on (see `setClosedLoop`).
+   *
+   * The path is followed by the controller's task, like `moveTo()`, so `isSettled()` and
+   * `waitUntilSettled()` report it and targets set while it runs are ignored.
+   *
+   * Each segment is searched for the same way as by `generatePath()`, so the path has the same
+   * shape as a generated one through the same waypoints. Its velocities differ: each waypoint is
+   * given the fastest velocity from which the robot can still come to a stop by the last waypoint,
+   * so segments can be generated one at a time and still join up. If the worker falls behind and
+   * the robot reaches the end of what has been generated, it brakes along its current arc at the
+   * path's maximum acceleration, logs a warning and the move ends there. The same happens if a
+   * later segment cannot be generated.
+   *
+   * Does not save the path which was generated.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ibackwards Whether to follow the profile backwards.
+   * @param imirrored Whether to follow the profile mirrored.
+   */
+  void moveToStreaming(std::initializer_list<PathfinderPoint> iwaypoints,
+                       const bool ibackwards = false,
+                       const bool imirrored = false) {
+    moveToStreaming(iwaypoints, limits, ibackwards, imirrored);
+  }
+
+  /**
+   * Same as above, with limits used for this path only.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ilimits The limits to use for this path only.
+   * @param ibackwards Whether to follow the profile backwards.
+   * @param imirrored Whether to follow the profile mirrored.
+   */
+  void moveToStreaming(std::initializer_list<PathfinderPoint> iwaypoints,
+                       const PathfinderLimits &ilimits,
+                       const bool ibackwards = false,
+                       const bool imirrored = false) {
+    if (iwaypoints.size() < 2) {
+      return;
+    }
+    waitUntilSettled();
+
+    std::vector<squiggles::Pose> poses;
+    for (const auto &point : iwaypoints) {
+      poses.emplace_back(point.x.convert(meter), point.y.convert(meter), point.theta.convert(radian));
+    }
+
+    const squiggles::Constraints constraints(ilimits.maxVel, ilimits.maxAccel, ilimits.maxJerk);
+    StreamingPath stream{
+      squiggles::SplineGenerator(
+        constraints,
+        std::make_shared<squiggles::TankModel>(scales.wheelTrack.convert(meter), constraints),
+        DT),
+      poses,
+      streamingKnotVelocities(poses, ilimits),
+      ilimits.maxAccel};
+
+    if (!stream.append(0)) {
+      LOG_ERROR_S("AsyncRamseteMotionProfileController: Failed to generate the first segment of "
+                  "a streamed path.");
+      return;
+    }
+
+    // The task runs the stream through an empty entry in paths, which executeSinglePath recognizes
+    static int streamCount = 0;
+    const std::string pathId = "__streamingPath" + std::to_string(streamCount++);
+    {
+      std::scoped_lock lock(currentPathMutex);
+      stream.placeholder = &paths[pathId];
+    }
+    {
+      std::scoped_lock lock(streamMutex);
+      activeStream = &stream;
+    }
+
+    // The worker must finish before the stream goes out of scope. The task is not deleted until
+    // its function has returned.
+    auto worker = std::make_unique<CrossplatformThread>(
+      streamingTrampoline, &stream, "AsyncRamseteMotionProfileController streaming");
+
+    setTarget(pathId, ibackwards, imirrored);
+    waitUntilSettled();
+
+    {
+      // If the controller was disabled, the task may still be braking. This waits for it to
+      // return, and stops it from picking up the stream later.
+      std::scoped_lock lock(streamMutex);
+      activeStream = nullptr;
+    }
+    removePath(pathId);
+
+    stream.cancelled.store(true, std::memory_order_release);
+    auto rate = timeUtil.getRate();
+    while (!stream.finished()) {
+      rate->delayUntil(10_ms);
+    }
+  }
+
+  protected:
+  PoseSource poseSource;
+  RamseteGains gains;
+  std::atomic_bool closedLoop{true};
+  std::atomic<double> errorX{0};
+  std::atomic<double> errorY{0};
+  std::atomic<double> errorTheta{0};
+  mutable CrossplatformMutex statsMutex;
+  TimingStats stats;
+  struct StreamingPath;
+  // Paths are generated with a TankModel, so every point has two wheel velocities
+  using Profile = squiggles::UniformProfile<2>;
+  using Sample = Profile::Sample;
+  // This must be locked when accessing the active stream, and is held while following it
+  CrossplatformMutex streamMutex;
+  StreamingPath *activeStream{nullptr};
+
+  /**
+   * Follow the supplied path, correcting for the robot's measured pose if closed loop following
+   * is on. Must follow the disabled lifecycle.
+   */
+  void executeSinglePath(const std::vector<squiggles::ProfilePoint> &path,
+                         std::unique_ptr<AbstractRate> rate) override {
+    {
+      std::scoped_lock lock(streamMutex);
+      if (activeStream != nullptr && &path == activeStream->placeholder) {
+        followStream(*activeStream, *rate);
+        return;
+      }
+    }
+
+    const auto reversed = direction.load(std::memory_order_acquire);
+    const bool followMirrored = mirrored.load(std::memory_order_acquire);
+    const bool closed = poseSource && isClosedLoop();
+
+    if (path.empty()) {
+      return;
+    }
+
+    const squiggles::Pose pathStart = path.front().vector.pose;
+    const squiggles::Pose robotStart = closed ? poseSource() : squiggles::Pose();
+
+    // Resampled onto the control period, so finding a tick's sample is a direct index no matter
+    // how long the path is, and the loop below does not allocate
+    const Profile profile(path, DT);
+
+    // The profile is indexed by the time since the path started rather than by counting ticks,
+    // so a late tick skips ahead instead of stretching the rest of the path
+    const QTime start = preciseTime();
+    QTime lastTick = start;
+    std::size_t cursor = 0;
+    resetStats(profile.duration() * second);
+
+    while (!isDisabled()) {
+      const QTime now = preciseTime();
+      const std::size_t previous = cursor;
+      const double elapsed = (now - start).convert(second);
+      const bool more = elapsed < profile.duration();
+      cursor = profile.index(profile.start + elapsed);
+      {
+        // This mutex is used to combat an edge case of an edge case
+        // if a running path is asked to be removed at the moment this loop is executing
+        std::scoped_lock lock(currentPathMutex);
+        drive(profile.at(profile.start + elapsed), pathStart, robotStart, reversed,
+              followMirrored, closed);
+      }
+      recordTick(now, lastTick, start, previous, cursor);
+      lastTick = now;
+
+      if (!more) {
+        break;
+      }
+      rate->delayUntil(10_ms);
+    }
+  }
+
+  /**
+   * Follows a streamed path while its worker appends to it. Must follow the disabled lifecycle.
+   */
+  void followStream(StreamingPath &istream, AbstractRate &irate) {
+    const auto reversed = direction.load(std::memory_order_acquire);
+    const bool followMirrored = mirrored.load(std::memory_order_acquire);
+    const bool closed = poseSource && isClosedLoop();
+    const squiggles::Pose pathStart = istream.waypoints.front();
+    const squiggles::Pose robotStart = closed ? poseSource() : squiggles::Pose();
+
+    const QTime start = preciseTime();
+    QTime lastTick = start;
+    std::size_t cursor = 0;
+    Sample point;
+    resetStats(0_ms);
+
+    while (!isDisabled()) {
+      // Read this first so that every segment the worker appended before finishing is seen below
+      const bool workerFinished = istream.finished();
+      const QTime now = preciseTime();
+      const std::size_t previous = cursor;
+      bool available = false;
+      {
+        std::scoped_lock lock(istream.mutex);
+        available = sampleAt(istream.points, (now - start).convert(second), cursor, point);
+      }
+      recordTick(now, lastTick, start, previous, cursor);
+      lastTick = now;
+
+      if (!available) {
+        if (workerFinished && istream.complete.load(std::memory_order_acquire)) {
+          drive(point, pathStart, robotStart, reversed, followMirrored, closed);
+          break;
+        }
+        LOG_WARN_S("AsyncRamseteMotionProfileController: Path generation fell behind or failed. "
+                   "Stopping the streamed path early.");
+        istream.cancelled.store(true, std::memory_order_release);
+        brake(point, istream.maxAccel, pathStart, robotStart, reversed, followMirrored, closed,
+              irate);
+        break;
+      }
+
+      drive(point, pathStart, robotStart, reversed, followMirrored, closed);
+      irate.delayUntil(10_ms);
+    }
+
+    std::scoped_lock lock(istream.mutex);
+    if (!istream.points.empty()) {
+      std::scoped_lock statsLock(statsMutex);
+      stats.plannedDuration = (istream.points.back().time - istream.points.front().time) * second;
+    }
+  }
+
+  /**
+   * Finds the state `itime` seconds after the start of a profile, interpolating between the two
+   * points around it. `icursor` is the index of the point at or before the last time sampled, and
+   * is moved forward, so a whole path is sampled in linear time. The profile must not be empty.
+   * The state is written field by field, so sampling does not allocate.
+   *
+   * @param ipath The profile.
+   * @param itime The time since the first point of the profile.
+   * @param icursor The point to start searching from. Updated to the point at or before `itime`.
+   * @param ostate The interpolated state.
+   * @return False if `itime` is at or past the last point, in which case `ostate` is the last
+   * point.
+   */
+  static bool sampleAt(const std::vector<squiggles::ProfilePoint> &ipath,
+                       const double itime,
+                       std::size_t &icursor,
+                       Sample &ostate) {
+    const double t = ipath.front().time + itime;
+    const std::size_t last = ipath.size() - 1;
+    while (icursor < last && ipath[icursor + 1].time <= t) {
+      ++icursor;
+    }
+    const bool more = icursor < last;
+
+    const auto &a = ipath[icursor];
+    const auto &b = ipath[more ? icursor + 1 : last];
+    const double span = b.time - a.time;
+    const double f = more && span > 0 ? std::clamp((t - a.time) / span, 0.0, 1.0) : 0.0;
+    const auto lerp = [f](const double x, const double y) { return x + (y - x) * f; };
+
+    ostate.vector.pose.x = lerp(a.vector.pose.x, b.vector.pose.x);
+    ostate.vector.pose.y = lerp(a.vector.pose.y, b.vector.pose.y);
+    ostate.vector.pose.yaw =
+      a.vector.pose.yaw + std::remainder(b.vector.pose.yaw - a.vector.pose.yaw, 2 * M_PI) * f;
+    ostate.vector.vel = lerp(a.vector.vel, b.vector.vel);
+    ostate.vector.accel = lerp(a.vector.accel, b.vector.accel);
+    ostate.vector.jerk = lerp(a.vector.jerk, b.vector.jerk);
+    ostate.curvature = lerp(a.curvature, b.curvature);
+    ostate.time = more ? t : a.time;
+    for (std::size_t w = 0; w < ostate.wheel_velocities.size(); ++w) {
+      ostate.wheel_velocities[w] =
+        w < a.wheel_velocities.size() && w < b.wheel_velocities.size()
+          ? lerp(a.wheel_velocities[w], b.wheel_velocities[w])
+          : 0;
+    }
+    return more;
+  }
+
+  /**
+   * The current time from a microsecond clock: pros::micros() on the brain and the steady clock
+   * in host builds. TimeUtil's timers count whole milliseconds, which would move each tick's
+   * place in a 10 ms profile by up to a tenth of a sample and make the lateness statistics jitter
+   * by a millisecond.
+   */
+  static QTime preciseTime() {
+#ifdef THREADS_STD
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch())
+             .count() *
+           second;
+#else
+    return static_cast<double>(pros::c::micros()) / 1e6 * second;
+#endif
+  }
+
+  void resetStats(const QTime iplannedDuration) {
+    std::scoped_lock lock(statsMutex);
+    stats = TimingStats();
+    stats.plannedDuration = iplannedDuration;
+  }
+
+  /**
+   * Adds one tick to the timing statistics.
+   */
+  void recordTick(const QTime inow,
+                  const QTime ilastTick,
+                  const QTime istart,
+                  const std::size_t iprevious,
+                  const std::size_t icursor) {
+    std::scoped_lock lock(statsMutex);
+    if (stats.ticks > 0) {
+      const QTime lateness = inow - ilastTick - DT * second;
+      if (lateness > DT * second / 2) {
+        ++stats.overruns;
+      }
+      stats.maxLateness = std::max(stats.maxLateness, lateness);
+      if (icursor > iprevious + 1) {
+        stats.skippedSamples += icursor - iprevious - 1;
+      }
+    }
+    ++stats.ticks;
+    stats.actualDuration = inow - istart;
+  }
+
+  /**
+   * A path being generated one segment at a time while it is followed.
+   */
+  struct StreamingPath {
+    squiggles::SplineGenerator generator;
+    std::vector<squiggles::Pose> waypoints;
+    std::vector<double> velocities;
+    double maxAccel;
+    // The entry in paths the controller's task is given for this stream
+    const std::vector<squiggles::ProfilePoint> *placeholder{nullptr};
+    // This must be locked when accessing the points
+    CrossplatformMutex mutex{};
+    std::vector<squiggles::ProfilePoint> points{};
+    std::atomic_bool cancelled{false};
+    std::atomic_bool complete{false};
+    std::atomic_bool workerDone{false};
+
+    /**
+     * Generates the segment starting at waypoint `isegment` and appends it to the points.
+     *
+     * @return Whether the segment could be generated.
+     */
+    bool append(const std::size_t isegment) {
+      squiggles::ControlVector start(waypoints[isegment]);
+      squiggles::ControlVector end(waypoints[isegment + 1]);
+      double startTime = 0;
+      {
+        std::scoped_lock lock(mutex);
+        if (!points.empty()) {
+          startTime = points.back().time;
+        }
+      }
+
+      std::vector<squiggles::ProfilePoint> segment;
+      try {
+        const auto raw = generator.gen_raw_path(start, end, false);
+        segment = generator.parameterize(
+          start, end, raw, velocities[isegment], velocities[isegment + 1], startTime);
+      } catch (const std::exception &) {
+        return false;
+      }
+      if (segment.empty()) {
+        return false;
+      }
+
+      std::scoped_lock lock(mutex);
+      // Each segment starts where the last one ended
+      points.insert(points.end(), segment.begin() + (isegment == 0 ? 0 : 1), segment.end());
+      return true;
+    }
+
+    /**
+     * @return Whether the worker has stopped, having generated every segment or not.
+     */
+    bool finished() const {
+      return workerDone.load(std::memory_order_acquire);
+    }
+  };
+
+  static void streamingTrampoline(void *context) {
+    auto &stream = *static_cast<StreamingPath *>(context);
+    bool ok = true;
+    for (std::size_t i = 1; ok && i + 1 < stream.waypoints.size() &&
+                            !stream.cancelled.load(std::memory_order_acquire);
+         ++i) {
+      ok = stream.append(i);
+    }
+    stream.complete.store(ok && !stream.cancelled.load(std::memory_order_acquire),
+                          std::memory_order_release);
+    stream.workerDone.store(true, std::memory_order_release);
+  }
+
+  /**
+   * The velocity at each waypoint of a streamed path: as fast as possible while still being able
+   * to accelerate to it from the start and stop by the end. Distances are measured along the
+   * straight line between waypoints, which is never longer than the path, so the velocities are
+   * reachable however each segment curves.
+   */
+  static std::vector<double> streamingKnotVelocities(const std::vector<squiggles::Pose> &iposes,
+                                                     const PathfinderLimits &ilimits) {
+    std::vector<double> out(iposes.size(), ilimits.maxVel);
+    out.front() = 0;
+    out.back() = 0;
+    const auto chord = [&](std::size_t i) {
+      return std::hypot(iposes[i + 1].x - iposes[i].x, iposes[i + 1].y - iposes[i].y);
+    };
+    for (std::size_t i = 1; i < out.size(); ++i) {
+      out[i] = std::min(out[i], std::sqrt(out[i - 1] * out[i - 1] + 2 * ilimits.maxAccel * chord(i - 1)));
+    }
+    for (std::size_t i = out.size() - 1; i-- > 0;) {
+      out[i] = std::min(out[i], std::sqrt(out[i + 1] * out[i + 1] + 2 * ilimits.maxAccel * chord(i)));
+    }
+    return out;
+  }
+
+  /**
+   * Sends the wheel velocities for one profile point to the chassis.
+   */
+  void drive(const Sample &ipoint,
+             const squiggles::Pose &ipathStart,
+             const squiggles::Pose &irobotStart,
+             const int ireversed,
+             const bool imirrored,
+             const bool iclosedLoop) {
+    double leftVel = ipoint.wheel_velocities[imirrored ? 1 : 0] * ireversed;
+    double rightVel = ipoint.wheel_velocities[imirrored ? 0 : 1] * ireversed;
+    if (iclosedLoop) {
+      const auto step = ramseteStep(
+        ipoint, ipathStart, irobotStart, poseSource(), ireversed, imirrored,
+        scales.wheelTrack.convert(meter), gains);
+      leftVel = step.leftVel;
+      rightVel = step.rightVel;
+      errorX.store(step.error.x, std::memory_order_release);
+      // The step's error has +y to the left and yaw counterclockwise
+      errorY.store(-step.error.y, std::memory_order_release);
+      errorTheta.store(-step.error.yaw, std::memory_order_release);
+    }
+
+    model->left(convertLinearToRotational(leftVel * mps).convert(rpm) /
+                toUnderlyingType(pair.internalGearset));
+    model->right(convertLinearToRotational(rightVel * mps).convert(rpm) /
+                 toUnderlyingType(pair.internalGearset));
+  }
+
+  /**
+   * Brings the robot to a stop from the given profile point, continuing along its arc and slowing
+   * down at the given acceleration.
+   */
+  void brake(Sample ipoint,
+             const double imaxAccel,
+             const squiggles::Pose &ipathStart,
+             const squiggles::Pose &irobotStart,
+             const int ireversed,
+             const bool imirrored,
+             const bool iclosedLoop,
+             AbstractRate &irate) {
+    const auto initialWheels = ipoint.wheel_velocities;
+    const double initialVel = ipoint.vector.vel;
+    while (ipoint.vector.vel > 0 && !isDisabled()) {
+      const double vel = std::max(0.0, ipoint.vector.vel - imaxAccel * DT);
+      const double ds = (ipoint.vector.vel + vel) / 2 * DT;
+      const double dyaw = ds * ipoint.curvature;
+      squiggles::Pose &pose = ipoint.vector.pose;
+      pose.x += ds * std::cos(pose.yaw + dyaw / 2);
+      pose.y += ds * std::sin(pose.yaw + dyaw / 2);
+      pose.yaw += dyaw;
+      ipoint.vector.vel = vel;
+      for (std::size_t w = 0; w < initialWheels.size(); ++w) {
+        ipoint.wheel_velocities[w] = initialWheels[w] * vel / initialVel;
+      }
+      drive(ipoint, ipathStart, irobotStart, ireversed, imirrored, iclosedLoop);
+      irate.delayUntil(10_ms);
+    }
+  }
+};
+} // namespace okapi
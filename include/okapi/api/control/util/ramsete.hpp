@@ -0,0 +1,153 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "squiggles.hpp"
+#include <cmath>
+
+namespace okapi {
+/**
+ * The tuning of the RAMSETE controller. `b` (> 0) sets how aggressively position error is
+ * corrected, like a proportional gain. `zeta` (between 0 and 1) is the damping.
+ */
+struct RamseteGains {
+  double b{2.0};
+  double zeta{0.7};
+};
+
+/**
+ * A linear and angular velocity for a unicycle (differential drive) robot.
+ */
+struct UnicycleCommand {
+  double linear;  // meters per second
+  double angular; // radians per second, positive from +x towards +y
+};
+
+/**
+ * The RAMSETE tracking law. Given where the robot should be, the velocities the profile wants
+ * there, and where the robot is, returns the velocities that drive the error to zero. With no
+ * error it returns the profile's velocities unchanged.
+ *
+ * All poses must be in the same frame, with yaw measured from +x towards +y.
+ *
+ * @param itarget The pose the robot should be at.
+ * @param ilinear The profile's linear velocity at the target.
+ * @param iangular The profile's angular velocity at the target.
+ * @param iactual The pose the robot is at.
+ * @param igains The controller tuning.
+ * @return The corrected velocities.
+ */
+inline UnicycleCommand ramsete(const squiggles::Pose &itarget,
+                               const double ilinear,
+                               const double iangular,
+                               const squiggles::Pose &iactual,
+                               const RamseteGains &igains) {
+  // Error in the robot's frame
+  const double dx = itarget.x - iactual.x;
+  const double dy = itarget.y - iactual.y;
+  const double ex = std::cos(iactual.yaw) * dx + std::sin(iactual.yaw) * dy;
+  const double ey = -std::sin(iactual.yaw) * dx + std::cos(iactual.yaw) * dy;
+  const double etheta = std::remainder(itarget.yaw - iactual.yaw, 2 * M_PI);
+
+  const double k = 2 * igains.zeta * std::sqrt(iangular * iangular + igains.b * ilinear * ilinear);
+  const double sinc = std::fabs(etheta) < 1e-6 ? 1.0 : std::sin(etheta) / etheta;
+
+  return {ilinear * std::cos(etheta) + k * ex,
+          iangular + k * etheta + igains.b * ilinear * sinc * ey};
+}
+
+/**
+ * Applies the pose `irelative`, expressed in the frame of `ibase`, to `ibase`.
+ */
+inline squiggles::Pose composePose(const squiggles::Pose &ibase,
+                                   const squiggles::Pose &irelative) {
+  return squiggles::Pose(
+    ibase.x + std::cos(ibase.yaw) * irelative.x - std::sin(ibase.yaw) * irelative.y,
+    ibase.y + std::sin(ibase.yaw) * irelative.x + std::cos(ibase.yaw) * irelative.y,
+    ibase.yaw + irelative.yaw);
+}
+
+/**
+ * Expresses the pose `ipose` in the frame of `ibase`. The inverse of `composePose`.
+ */
+inline squiggles::Pose relativePose(const squiggles::Pose &ibase, const squiggles::Pose &ipose) {
+  const double dx = ipose.x - ibase.x;
+  const double dy = ipose.y - ibase.y;
+  return squiggles::Pose(std::cos(ibase.yaw) * dx + std::sin(ibase.yaw) * dy,
+                         -std::sin(ibase.yaw) * dx + std::cos(ibase.yaw) * dy,
+                         ipose.yaw - ibase.yaw);
+}
+
+/**
+ * The wheel velocities and tracking error for one tick of closed loop following.
+ */
+struct RamseteStep {
+  double leftVel;  // meters per second
+  double rightVel; // meters per second
+  squiggles::Pose error;
+};
+
+/**
+ * Computes one tick of closed loop following, without touching the robot. This is what
+ * `AsyncRamseteMotionProfileController` runs every 10 ms, and can be run against a simulated
+ * robot on the host.
+ *
+ * The poses are in the frame the profile's wheel velocities drive in: +x forward, +y to the
+ * robot's left and yaw counterclockwise, so that a faster right side turns towards +y.
+ *
+ * @param ipoint The profile point for this tick, a `squiggles::ProfilePoint` or a sample of a
+ * `squiggles::UniformProfile`.
+ * @param ipathStart The first pose of the path.
+ * @param irobotStart The robot's pose when the path started.
+ * @param iactual The robot's pose now.
+ * @param ireversed -1 if the path is followed backwards, otherwise 1.
+ * @param imirrored Whether the path is followed mirrored.
+ * @param itrack The distance between the left and right wheels in meters.
+ * @param igains The RAMSETE tuning.
+ * @return The left and right wheel velocities to command, and the error in the robot's frame
+ * (see `AsyncRamseteMotionProfileController::getError()`).
+ */
+template <typename Point>
+RamseteStep ramseteStep(const Point &ipoint,
+                        const squiggles::Pose &ipathStart,
+                        const squiggles::Pose &irobotStart,
+                        const squiggles::Pose &iactual,
+                        const int ireversed,
+                        const bool imirrored,
+                        const double itrack,
+                        const RamseteGains &igains) {
+  // Driving backwards reflects the path across the robot's y axis and following it mirrored
+  // reflects it across the x axis. Either one turns the robot the other way.
+  squiggles::Pose local = relativePose(ipathStart, ipoint.vector.pose);
+  if (ireversed < 0) {
+    local.x = -local.x;
+    local.yaw = -local.yaw;
+  }
+  if (imirrored) {
+    local.y = -local.y;
+    local.yaw = -local.yaw;
+  }
+  const squiggles::Pose target = composePose(irobotStart, local);
+  const double turnSign = ireversed * (imirrored ? -1 : 1);
+
+  const double linear = ipoint.vector.vel * ireversed;
+  const double angular = ipoint.vector.vel * ipoint.curvature * turnSign;
+  const UnicycleCommand command = ramsete(target, linear, angular, iactual, igains);
+
+  // Add the correction to the profile's own wheel velocities so that with no error the robot
+  // is driven exactly as it would be open loop. squiggles' tank models turn from +x towards +y
+  // by speeding up the right side ({lin - turn, lin + turn}), so the correction does too.
+  const double linearCorrection = command.linear - linear;
+  const double turnCorrection = (command.angular - angular) * itrack / 2;
+  squiggles::Pose error = relativePose(iactual, target);
+  error.yaw = std::remainder(error.yaw, 2 * M_PI);
+  return {ipoint.wheel_velocities[imirrored ? 1 : 0] * ireversed + linearCorrection -
+            turnCorrection,
+          ipoint.wheel_velocities[imirrored ? 0 : 1] * ireversed + linearCorrection +
+            turnCorrection,
+          error};
+}
+} // namespace okapi
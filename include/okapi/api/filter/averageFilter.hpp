@@ -8,6 +8,7 @@
 #include "okapi/api/filter/filter.hpp"
 #include <array>
 #include <cstddef>
+#include <typeinfo>
 
 namespace okapi {
 /**
@@ -42,6 +43,28 @@ template <std::size_t n> class AverageFilter : public Filter {
     return output;
   }
 
+  /**
+   * Filters a block of values in order. The outputs and the state of the filter afterwards are
+   * the same as calling `filter()` on each value in turn. `ireadings` and `ioutputs` may be the
+   * same array.
+   *
+   * The type is checked once per block, so an AverageFilter is stepped without virtual calls and a
+   * subclass which overrides `filter()` still goes through its override.
+   *
+   * @param ireadings The measurements.
+   * @param ioutputs Where to write the filtered results.
+   * @param icount The number of measurements.
+   */
+  void filter(const double *ireadings, double *ioutputs, const std::size_t icount) {
+    if (typeid(*this) != typeid(AverageFilter)) {
+      Filter::filter(ireadings, ioutputs, icount);
+      return;
+    }
+    for (std::size_t i = 0; i < icount; i++) {
+      ioutputs[i] = AverageFilter::filter(ireadings[i]);
+    }
+  }
+
   /**
    * Returns the previous output from filter.
    *
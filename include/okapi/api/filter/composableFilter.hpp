@@ -6,6 +6,8 @@
 #pragma once
 
 #include "okapi/api/filter/filter.hpp"
+#include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <initializer_list>
 #include <memory>
@@ -31,6 +33,31 @@ class ComposableFilter : public Filter {
    */
   double filter(double ireading) override;
 
+  /**
+   * Filters a block of values in order. The outputs and the state of the filter afterwards are
+   * the same as calling `filter()` on each value in turn. `ireadings` and `ioutputs` may be the
+   * same array.
+   *
+   * @param ireadings The measurements.
+   * @param ioutputs Where to write the filtered results.
+   * @param icount The number of measurements.
+   */
+  void filter(const double *ireadings, double *ioutputs, const std::size_t icount) {
+    if (icount == 0) {
+      return;
+    }
+    if (ioutputs != ireadings) {
+      std::copy(ireadings, ireadings + icount, ioutputs);
+    }
+
+    // Each stage only sees the output of the one before it, so running the whole block through
+    // one stage at a time gives the same result as running each value through every stage
+    for (auto &stage : filters) {
+      stage->filter(ioutputs, ioutputs, icount);
+    }
+    output = ioutputs[icount - 1];
+  }
+
   /**
    * @return The previous output from filter.
    */
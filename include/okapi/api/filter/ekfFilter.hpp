@@ -7,6 +7,8 @@
 
 #include "okapi/api/filter/filter.hpp"
 #include "okapi/api/util/mathUtil.hpp"
+#include <cstddef>
+#include <typeinfo>
 
 namespace okapi {
 class EKFFilter : public Filter {
@@ -51,6 +53,53 @@ class EKFFilter : public Filter {
    */
   virtual double filter(double ireading, double icontrol);
 
+  /**
+   * Filters a block of values in order. The outputs and the state of the filter afterwards are
+   * the same as calling `filter()` on each value in turn. `ireadings` and `ioutputs` may be the
+   * same array.
+   *
+   * The type is checked once per block, so an EKFFilter is stepped without virtual calls and a
+   * subclass which overrides `filter()` still goes through its override.
+   *
+   * @param ireadings The measurements.
+   * @param ioutputs Where to write the filtered results.
+   * @param icount The number of measurements.
+   */
+  void filter(const double *ireadings, double *ioutputs, const std::size_t icount) {
+    if (typeid(*this) != typeid(EKFFilter)) {
+      Filter::filter(ireadings, ioutputs, icount);
+      return;
+    }
+    for (std::size_t i = 0; i < icount; i++) {
+      ioutputs[i] = EKFFilter::filter(ireadings[i]);
+    }
+  }
+
+  /**
+   * Filters a block of readings with their control inputs, like `filter(ireading, icontrol)` on
+   * each pair in turn. `ireadings` and `ioutputs` may be the same array. Like the block overload
+   * above, an EKFFilter is stepped without virtual calls.
+   *
+   * @param ireadings The measurements.
+   * @param icontrols The control input for each measurement.
+   * @param ioutputs Where to write the filtered results.
+   * @param icount The number of measurements.
+   */
+  void filter(const double *ireadings,
+              const double *icontrols,
+              double *ioutputs,
+              const std::size_t icount) {
+    if (typeid(*this) != typeid(EKFFilter)) {
+      for (std::size_t i = 0; i < icount; i++) {
+        ioutputs[i] = filter(ireadings[i], icontrols[i]);
+      }
+      return;
+    }
+    for (std::size_t i = 0; i < icount; i++) {
+      ioutputs[i] = EKFFilter::filter(ireadings[i], icontrols[i]);
+    }
+  }
+
   /**
    * Returns the previous output from filter.
    *
@@ -5,6 +5,8 @@
  */
 #pragma once
 
+#include <cstddef>
+
 namespace okapi {
 class Filter {
   public:
@@ -18,6 +20,27 @@ class Filter {
    */
   virtual double filter(double ireading) = 0;
 
+  /**
+   * Filters a block of values, like a log of sensor readings, in order. The outputs, and the
+   * state of the filter afterwards, are exactly what calling `filter()` on each value in turn
+   * would give, so a signal can be filtered in several blocks or mixed with single readings.
+   * `ireadings` and `ioutputs` may be the same array.
+   *
+   * Here each value goes through the virtual `filter()`, so a subclass only needs to override
+   * that. The filters in okapi hide this with a block overload which checks their type once and
+   * then steps without virtual calls, falling back to this one for subclasses. Filters whose types
+   * are known at compile time can also be chained without virtual calls with a `FilterChain`.
+   *
+   * @param ireadings The measurements.
+   * @param ioutputs Where to write the filtered results.
+   * @param icount The number of measurements.
+   */
+  void filter(const double *ireadings, double *ioutputs, const std::size_t icount) {
+    for (std::size_t i = 0; i < icount; i++) {
+      ioutputs[i] = filter(ireadings[i]);
+    }
+  }
+
   /**
    * Returns the previous output from filter.
    *
@@ -0,0 +1,187 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/filter/filter.hpp"
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+namespace okapi {
+/**
+ * A sequence of filters fixed at compile time. The input signal is passed through each filter in
+ * order, like `ComposableFilter`, but the filters are stored by value and each one is called
+ * directly instead of through a pointer and a virtual call. Filters defined in headers (such as
+ * `MedianFilter` and `AverageFilter`) are inlined into one function.
+ *
+ * A FilterChain is not itself a `Filter`. Wrap it in a `FilterAdapter` to pass it where a `Filter`
+ * is expected.
+ *
+ * @tparam Fs The filters, in order. Each needs a `double filter(double)` method.
+ */
+template <class... Fs> class FilterChain {
+  static_assert(sizeof...(Fs) > 0, "FilterChain needs at least one filter");
+
+  public:
+  FilterChain() = default;
+
+  /**
+   * @param ifilters The filters to use in sequence.
+   */
+  explicit FilterChain(Fs... ifilters) : filters(std::move(ifilters)...) {
+  }
+
+  /**
+   * Filters a value.
+   *
+   * @param ireading A new measurement.
+   * @return The filtered result.
+   */
+  double filter(const double ireading) {
+    output = filterFrom<0>(ireading);
+    return output;
+  }
+
+  /**
+   * Filters a block of values in order, one filter at a time over the whole block. The outputs
+   * and the state of each filter afterwards are the same as calling `filter()` on each value in
+   * turn. `ireadings` and `ioutputs` may be the same array.
+   *
+   * @param ireadings The measurements.
+   * @param ioutputs Where to write the filtered results.
+   * @param icount The number of measurements.
+   */
+  void filter(const double *ireadings, double *ioutputs, const std::size_t icount) {
+    if (icount == 0) {
+      return;
+    }
+    blockFrom<0>(ireadings, ioutputs, icount);
+    output = ioutputs[icount - 1];
+  }
+
+  /**
+   * @return The previous output from filter.
+   */
+  double getOutput() const {
+    return output;
+  }
+
+  /**
+   * @return The filter at position `I`, for example to change its gains.
+   */
+  template <std::size_t I> auto &get() {
+    return std::get<I>(filters);
+  }
+
+  template <std::size_t I> const auto &get() const {
+    return std::get<I>(filters);
+  }
+
+  static constexpr std::size_t size() {
+    return sizeof...(Fs);
+  }
+
+  protected:
+  std::tuple<Fs...> filters;
+  double output = 0;
+
+  template <std::size_t I> double filterFrom(const double ivalue) {
+    using Stage = std::tuple_element_t<I, std::tuple<Fs...>>;
+    // Qualified so the call is bound at compile time even if Stage::filter is virtual
+    const double value = std::get<I>(filters).Stage::filter(ivalue);
+    if constexpr (I + 1 < sizeof...(Fs)) {
+      return filterFrom<I + 1>(value);
+    } else {
+      return value;
+    }
+  }
+
+  template <std::size_t I>
+  void blockFrom(const double *ireadings, double *ioutputs, const std::size_t icount) {
+    using Stage = std::tuple_element_t<I, std::tuple<Fs...>>;
+    auto &stage = std::get<I>(filters);
+    for (std::size_t i = 0; i < icount; i++) {
+      ioutputs[i] = stage.Stage::filter(ireadings[i]);
+    }
+    if constexpr (I + 1 < sizeof...(Fs)) {
+      blockFrom<I + 1>(ioutputs, ioutputs, icount);
+    }
+  }
+};
+
+template <class... Fs> FilterChain(Fs...) -> FilterChain<Fs...>;
+
+/**
+ * Makes any type with a `double filter(double)` method usable as a `Filter`, such as a
+ * `FilterChain`. The wrapped filter is stored by value, and the only virtual call is the one into
+ * the adapter.
+ *
+ * @tparam F The type to wrap.
+ */
+template <class F> class FilterAdapter : public Filter {
+  public:
+  FilterAdapter() = default;
+
+  /**
+   * @param ifilter The filter to wrap.
+   */
+  explicit FilterAdapter(F ifilter) : wrapped(std::move(ifilter)) {
+  }
+
+  /**
+   * Filters a value, like a sensor reading.
+   *
+   * @param ireading new measurement
+   * @return filtered result
+   */
+  double filter(const double ireading) override {
+    output = wrapped.F::filter(ireading);
+    return output;
+  }
+
+  /**
+   * Filters a block of values in order. The outputs and the state of the filter afterwards are
+   * the same as calling `filter()` on each value in turn. `ireadings` and `ioutputs` may be the
+   * same array.
+   *
+   * @param ireadings The measurements.
+   * @param ioutputs Where to write the filtered results.
+   * @param icount The number of measurements.
+   */
+  void filter(const double *ireadings, double *ioutputs, const std::size_t icount) {
+    for (std::size_t i = 0; i < icount; i++) {
+      ioutputs[i] = wrapped.F::filter(ireadings[i]);
+    }
+    if (icount > 0) {
+      output = ioutputs[icount - 1];
+    }
+  }
+
+  /**
+   * Returns the previous output from filter.
+   *
+   * @return the previous output from filter
+   */
+  double getOutput() const override {
+    return output;
+  }
+
+  /**
+   * @return The wrapped filter.
+   */
+  F &get() {
+    return wrapped;
+  }
+
+  const F &get() const {
+    return wrapped;
+  }
+
+  protected:
+  F wrapped;
+  double output = 0;
+};
+} // namespace okapi
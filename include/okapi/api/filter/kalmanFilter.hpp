@@ -0,0 +1,241 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/util/fixedMatrix.hpp"
+#include <cstddef>
+#include <utility>
+
+namespace okapi {
+/**
+ * A multivariate Kalman filter with its sizes fixed at compile time. Every matrix is stored in
+ * place, so a step never allocates, and the step functions are in this header so the compiler
+ * can unroll them for the sizes used.
+ *
+ * The linear model is
+ *
+ *   x' = A * x + B * u + w,   w ~ N(0, Q)
+ *   z  = H * x + v,           v ~ N(0, R)
+ *
+ * `predict()` and `update()` are separate so a filter can predict at the loop rate and update
+ * whenever a measurement arrives, or update with several sensors in turn. Both also have an
+ * extended form which takes the nonlinear model and its Jacobian as callbacks for that step
+ * only. The callbacks are template parameters, so lambdas are called directly and nothing is
+ * allocated.
+ *
+ * The covariance is updated in Joseph form, `P = (I - K H) P (I - K H)^T + K R K^T`, which keeps
+ * it symmetric and positive definite despite rounding.
+ *
+ * Angles in the state are not wrapped. If a measurement is an angle, make the measurement model
+ * return a value within pi of the measurement.
+ *
+ * @tparam NX The number of states.
+ * @tparam NU The number of control inputs. Can be zero.
+ * @tparam NZ The number of values in a measurement.
+ */
+template <std::size_t NX, std::size_t NU, std::size_t NZ> class KalmanFilter {
+  static_assert(NX > 0, "KalmanFilter needs at least one state");
+  static_assert(NZ > 0, "KalmanFilter needs at least one measurement");
+
+  public:
+  using State = FixedVector<NX>;
+  using Input = FixedVector<NU>;
+  using Measurement = FixedVector<NZ>;
+  using StateMatrix = FixedMatrix<NX, NX>;
+  using InputMatrix = FixedMatrix<NX, NU>;
+  using OutputMatrix = FixedMatrix<NZ, NX>;
+  using MeasurementMatrix = FixedMatrix<NZ, NZ>;
+  using GainMatrix = FixedMatrix<NX, NZ>;
+
+  /**
+   * A linear Kalman filter.
+   *
+   * @param iA The state transition matrix for one step.
+   * @param iB The control input matrix.
+   * @param iH The measurement matrix.
+   * @param iQ The process noise covariance.
+   * @param iR The measurement noise covariance.
+   * @param ix0 The initial state.
+   * @param iP0 The initial state covariance.
+   */
+  KalmanFilter(const StateMatrix &iA,
+               const InputMatrix &iB,
+               const OutputMatrix &iH,
+               const StateMatrix &iQ,
+               const MeasurementMatrix &iR,
+               const State &ix0 = State(),
+               const StateMatrix &iP0 = StateMatrix::identity())
+    : A(iA), B(iB), H(iH), Q(iQ), R(iR), x(ix0), P(iP0) {
+  }
+
+  /**
+   * A Kalman filter for use with only the extended `predict()` and `update()`, which take the
+   * models as callbacks. The linear model is the identity with no inputs or measurements.
+   *
+   * @param iQ The process noise covariance.
+   * @param iR The measurement noise covariance.
+   * @param ix0 The initial state.
+   * @param iP0 The initial state covariance.
+   */
+  KalmanFilter(const StateMatrix &iQ,
+               const MeasurementMatrix &iR,
+               const State &ix0 = State(),
+               const StateMatrix &iP0 = StateMatrix::identity())
+    : A(StateMatrix::identity()), Q(iQ), R(iR), x(ix0), P(iP0) {
+  }
+
+  /**
+   * Predicts the state one step ahead with the linear model.
+   *
+   * @param iu The control input during the step.
+   */
+  void predict(const Input &iu = Input()) {
+    x = A * x + B * iu;
+    P = A * P * A.transpose() + Q;
+  }
+
+  /**
+   * Predicts the state one step ahead with a nonlinear model (the extended Kalman filter).
+   *
+   * @param iu The control input during the step.
+   * @param imodel Called as `imodel(x, u)`. Returns the next State.
+   * @param ijacobian Called as `ijacobian(x, u)`. Returns the StateMatrix of the derivatives of
+   * the model's outputs with respect to x, at the current state.
+   */
+  template <class Model, class Jacobian>
+  void predict(const Input &iu, Model &&imodel, Jacobian &&ijacobian) {
+    const StateMatrix F = ijacobian(std::as_const(x), iu);
+    x = imodel(std::as_const(x), iu);
+    P = F * P * F.transpose() + Q;
+  }
+
+  /**
+   * Corrects the state with a measurement and the linear measurement model.
+   *
+   * @param iz The measurement.
+   * @return Whether the update was applied. It is skipped, leaving the filter unchanged, if the
+   * innovation covariance is not positive definite.
+   */
+  bool update(const Measurement &iz) {
+    return correct(iz - H * x, H);
+  }
+
+  /**
+   * Corrects the state with a measurement and a nonlinear measurement model (the extended Kalman
+   * filter).
+   *
+   * @param iz The measurement.
+   * @param imodel Called as `imodel(x)`. Returns the Measurement expected at state x.
+   * @param ijacobian Called as `ijacobian(x)`. Returns the OutputMatrix of the derivatives of
+   * the model's outputs with respect to x, at the current state.
+   * @return Whether the update was applied. It is skipped, leaving the filter unchanged, if the
+   * innovation covariance is not positive definite.
+   */
+  template <class Model, class Jacobian>
+  bool update(const Measurement &iz, Model &&imodel, Jacobian &&ijacobian) {
+    const OutputMatrix Hk = ijacobian(std::as_const(x));
+    return correct(iz - imodel(std::as_const(x)), Hk);
+  }
+
+  /**
+   * @return The current state estimate.
+   */
+  const State &getState() const {
+    return x;
+  }
+
+  /**
+   * @return The covariance of the current state estimate.
+   */
+  const StateMatrix &getCovariance() const {
+    return P;
+  }
+
+  /**
+   * Sets the state estimate, for example when the robot is placed at a known position.
+   *
+   * @param ix The new state.
+   */
+  void setState(const State &ix) {
+    x = ix;
+  }
+
+  /**
+   * Sets the covariance of the state estimate.
+   *
+   * @param iP The new covariance.
+   */
+  void setCovariance(const StateMatrix &iP) {
+    P = iP;
+  }
+
+  /**
+   * Sets the linear process model.
+   *
+   * @param iA The state transition matrix for one step.
+   * @param iB The control input matrix.
+   */
+  void setProcessModel(const StateMatrix &iA, const InputMatrix &iB) {
+    A = iA;
+    B = iB;
+  }
+
+  /**
+   * Sets the linear measurement model.
+   *
+   * @param iH The measurement matrix.
+   */
+  void setMeasurementModel(const OutputMatrix &iH) {
+    H = iH;
+  }
+
+  /**
+   * Sets the noise covariances.
+   *
+   * @param iQ The process noise covariance.
+   * @param iR The measurement noise covariance.
+   */
+  void setNoise(const StateMatrix &iQ, const MeasurementMatrix &iR) {
+    Q = iQ;
+    R = iR;
+  }
+
+  protected:
+  StateMatrix A;
+  InputMatrix B;
+  OutputMatrix H;
+  StateMatrix Q;
+  MeasurementMatrix R;
+  State x;
+  StateMatrix P;
+
+  bool correct(const Measurement &iinnovation, const OutputMatrix &iH) {
+    // P is symmetric, so K = P * H^T * S^-1 is the transpose of the solution of S * K^T = H * P
+    const FixedMatrix<NZ, NX> HP = iH * P;
+    const MeasurementMatrix S = HP * iH.transpose() + R;
+    FixedMatrix<NZ, NX> Kt;
+    if (!choleskySolve(S, HP, Kt)) {
+      return false;
+    }
+    const GainMatrix K = Kt.transpose();
+
+    x += K * iinnovation;
+
+    const StateMatrix IKH = StateMatrix::identity() - K * iH;
+    P = IKH * P * IKH.transpose() + K * R * Kt;
+
+    // Remove the asymmetry left by rounding
+    for (std::size_t i = 0; i < NX; i++) {
+      for (std::size_t j = i + 1; j < NX; j++) {
+        const double mean = (P(i, j) + P(j, i)) / 2;
+        P(i, j) = mean;
+        P(j, i) = mean;
+      }
+    }
+    return true;
+  }
+};
+} // namespace okapi
@@ -1,6 +1,4 @@
 /*
- * Uses the median filter algorithm from N. Wirth’s book, implementation by N. Devillard.
- *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
@@ -8,19 +6,32 @@
 #pragma once
 
 #include "okapi/api/filter/filter.hpp"
-#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <typeinfo>
+#include <utility>
 
 namespace okapi {
 /**
- * A filter which returns the median value of list of values.
+ * A filter which returns the median value of list of values. For an even number of taps, this is
+ * the lower of the two middle values.
+ *
+ * The window is kept split between a max-heap of its smallest values and a min-heap of the rest,
+ * so the median is always at the top of the first heap. Each reading replaces the oldest value in
+ * place and restores the heaps, which takes O(log n) time and no allocation.
  *
  * @tparam n number of taps in the filter
  */
 template <std::size_t n> class MedianFilter : public Filter {
+  static_assert(n > 0, "MedianFilter needs at least one tap");
+
   public:
   MedianFilter() : middleIndex((((n)&1) ? ((n) / 2) : (((n) / 2) - 1))) {
+    // The window starts as all zeros, which is already a valid split
+    for (std::size_t i = 0; i < n; i++) {
+      heap[i] = i;
+      position[i] = i;
+    }
   }
 
   /**
@@ -30,15 +41,54 @@ template <std::size_t n> class MedianFilter : public Filter {
    * @return filtered result
    */
   double filter(const double ireading) override {
-    data[index++] = ireading;
+    const std::size_t slot = index++;
     if (index >= n) {
       index = 0;
     }
 
-    output = kth_smallset();
+    data[slot] = ireading;
+    const std::size_t pos = position[slot];
+    if (pos < lowSize) {
+      siftUp(0, pos, true);
+      siftDown(0, lowSize, position[slot], true);
+    } else {
+      siftUp(lowSize, pos - lowSize, false);
+      siftDown(lowSize, n - lowSize, position[slot] - lowSize, false);
+    }
+
+    // Changing one value can move at most one value across the split
+    if (lowSize < n && data[heap[lowSize]] < data[heap[0]]) {
+      swapEntries(0, lowSize);
+      siftDown(0, lowSize, 0, true);
+      siftDown(lowSize, n - lowSize, 0, false);
+    }
+
+    output = data[heap[0]];
     return output;
   }
 
+  /**
+   * Filters a block of values in order. The outputs and the state of the filter afterwards are
+   * the same as calling `filter()` on each value in turn. `ireadings` and `ioutputs` may be the
+   * same array.
+   *
+   * The type is checked once per block, so a MedianFilter is stepped without virtual calls and a
+   * subclass which overrides `filter()` still goes through its override.
+   *
+   * @param ireadings The measurements.
+   * @param ioutputs Where to write the filtered results.
+   * @param icount The number of measurements.
+   */
+  void filter(const double *ireadings, double *ioutputs, const std::size_t icount) {
+    if (typeid(*this) != typeid(MedianFilter)) {
+      Filter::filter(ireadings, ioutputs, icount);
+      return;
+    }
+    for (std::size_t i = 0; i < icount; i++) {
+      ioutputs[i] = MedianFilter::filter(ireadings[i]);
+    }
+  }
+
   /**
    * Returns the previous output from filter.
    *
@@ -54,41 +104,69 @@ template <std::size_t n> class MedianFilter : public Filter {
   double output = 0;
   const size_t middleIndex;
 
+  // The number of values in the max-heap: the median and everything below it
+  static constexpr std::size_t lowSize = (n & 1) ? n / 2 + 1 : n / 2;
+
+  // Window slots, ordered as the max-heap in [0, lowSize) and the min-heap in [lowSize, n)
+  std::array<std::size_t, n> heap{};
+  // Where each window slot is in heap
+  std::array<std::size_t, n> position{};
+
+  /**
+   * Returns the median of the current window. Kept for subclasses written against the previous
+   * selection algorithm; the heaps make this a lookup.
+   */
+  double kth_smallset() const {
+    return data[heap[0]];
+  }
+
+  /**
+   * Whether the entry at heap position a belongs above the one at b in its heap.
+   */
+  bool above(const std::size_t a, const std::size_t b, const bool max) const {
+    return max ? data[heap[b]] < data[heap[a]] : data[heap[a]] < data[heap[b]];
+  }
+
+  void swapEntries(const std::size_t a, const std::size_t b) {
+    std::swap(heap[a], heap[b]);
+    position[heap[a]] = a;
+    position[heap[b]] = b;
+  }
+
   /**
-   * Algorithm from N. Wirth’s book, implementation by N. Devillard.
+   * Moves the entry at index i of the heap starting at base up to its place.
    */
-  double kth_smallset() {
-    std::array<double, n> dataCopy = data;
-    size_t j, l, m;
-    l = 0;
-    m = n - 1;
-
-    while (l < m) {
-      double x = dataCopy[middleIndex];
-      size_t i = l;
-      j = m;
-      do {
-        while (dataCopy[i] < x) {
-          i++;
-        }
-        while (x < dataCopy[j]) {
-          j--;
-        }
-        if (i <= j) {
-          const double t = dataCopy[i];
-          dataCopy[i] = dataCopy[j];
-          dataCopy[j] = t;
-          i++;
-          j--;
-        }
-      } while (i <= j);
-      if (j < middleIndex)
-        l = i;
-      if (middleIndex < i)
-        m = j;
+  void siftUp(const std::size_t base, std::size_t i, const bool max) {
+    while (i > 0) {
+      const std::size_t parent = (i - 1) / 2;
+      if (!above(base + i, base + parent, max)) {
+        break;
+      }
+      swapEntries(base + i, base + parent);
+      i = parent;
     }
+  }
 
-    return dataCopy[middleIndex];
+  /**
+   * Moves the entry at index i of the heap of the given size starting at base down to its place.
+   */
+  void siftDown(const std::size_t base, const std::size_t size, std::size_t i, const bool max) {
+    while (true) {
+      std::size_t best = i;
+      const std::size_t left = 2 * i + 1;
+      const std::size_t right = left + 1;
+      if (left < size && above(base + left, base + best, max)) {
+        best = left;
+      }
+      if (right < size && above(base + right, base + best, max)) {
+        best = right;
+      }
+      if (best == i) {
+        break;
+      }
+      swapEntries(base + i, base + best);
+      i = best;
+    }
   }
 };
 } // namespace okapi
@@ -6,6 +6,8 @@
 #pragma once
 
 #include "okapi/api/filter/filter.hpp"
+#include <cstddef>
+#include <typeinfo>
 
 namespace okapi {
 class PassthroughFilter : public Filter {
@@ -23,6 +25,28 @@ class PassthroughFilter : public Filter {
    */
   double filter(double ireading) override;
 
+  /**
+   * Filters a block of values in order. The outputs and the state of the filter afterwards are
+   * the same as calling `filter()` on each value in turn. `ireadings` and `ioutputs` may be the
+   * same array.
+   *
+   * The type is checked once per block, so a PassthroughFilter is stepped without virtual calls
+   * and a subclass which overrides `filter()` still goes through its override.
+   *
+   * @param ireadings The measurements.
+   * @param ioutputs Where to write the filtered results.
+   * @param icount The number of measurements.
+   */
+  void filter(const double *ireadings, double *ioutputs, const std::size_t icount) {
+    if (typeid(*this) != typeid(PassthroughFilter)) {
+      Filter::filter(ireadings, ioutputs, icount);
+      return;
+    }
+    for (std::size_t i = 0; i < icount; i++) {
+      ioutputs[i] = PassthroughFilter::filter(ireadings[i]);
+    }
+  }
+
   /**
    * Returns the previous output from filter.
    *
@@ -0,0 +1,59 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "ARMS/odomMath.h"
+#include "okapi/api/odometry/twoEncoderOdometry.hpp"
+#include <stdexcept>
+
+namespace okapi {
+class ArcTwoEncoderOdometry : public TwoEncoderOdometry {
+  public:
+  /**
+   * TwoEncoderOdometry which integrates each step with the exact constant-curvature arc update
+   * (the pose exponential map) instead of the polar-coordinate form. The result is the same arc,
+   * computed with one sin/cos pair of the heading and no atan2 or sqrt. Build with
+   * `-DARMS_ODOM_FLOAT` to run the kernel in single precision.
+   *
+   * @param itimeUtil The TimeUtil.
+   * @param imodel The chassis model for reading sensors.
+   * @param ichassisScales The chassis dimensions.
+   * @param ilogger The logger this instance will log to.
+   */
+  using TwoEncoderOdometry::TwoEncoderOdometry;
+
+  ~ArcTwoEncoderOdometry() override = default;
+
+  protected:
+  /**
+   * Does the math, side-effect free, for one odom step.
+   *
+   * @param itickDiff The tick difference from the previous step to this step.
+   * @param ideltaT The time difference from the previous step to this step.
+   * @return The newly computed OdomState.
+   */
+  OdomState odomMathStep(const std::valarray<std::int32_t> &itickDiff,
+                         const QTime &) override {
+    using real = arms::odom::odom_float_t;
+
+    if (itickDiff.size() < 2) {
+      LOG_ERROR_S("ArcTwoEncoderOdometry: itickDiff did not have at least two elements.");
+      throw std::runtime_error(
+        "ArcTwoEncoderOdometry: itickDiff did not have at least two elements.");
+    }
+
+    const real deltaL = static_cast<real>(itickDiff[0] / chassisScales.straight);
+    const real deltaR = static_cast<real>(itickDiff[1] / chassisScales.straight);
+    const real deltaTheta =
+      (deltaL - deltaR) / static_cast<real>(chassisScales.wheelTrack.convert(meter));
+
+    arms::odom::OdomPose<real> delta{0, 0, static_cast<real>(state.theta.convert(radian))};
+    arms::odom::arcStep(delta, (deltaL + deltaR) / real(2), real(0), deltaTheta);
+
+    return OdomState{delta.x * meter, delta.y * meter, deltaTheta * radian};
+  }
+};
+} // namespace okapi
@@ -0,0 +1,231 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+
+namespace okapi {
+/**
+ * A matrix of doubles with its size fixed at compile time. The values are stored in place, row
+ * by row, so a matrix never allocates and the compiler can unroll every operation on it.
+ *
+ * @tparam R The number of rows.
+ * @tparam C The number of columns.
+ */
+template <std::size_t R, std::size_t C> class FixedMatrix {
+  public:
+  /**
+   * A matrix of zeros.
+   */
+  FixedMatrix() = default;
+
+  /**
+   * A matrix from its values, row by row. Values which are not given are zero.
+   *
+   * @param ivalues The values.
+   */
+  FixedMatrix(std::initializer_list<double> ivalues) {
+    std::size_t i = 0;
+    for (const double value : ivalues) {
+      if (i >= R * C) {
+        break;
+      }
+      data[i++] = value;
+    }
+  }
+
+  static FixedMatrix identity() {
+    static_assert(R == C, "Only a square matrix has an identity");
+    FixedMatrix out;
+    for (std::size_t i = 0; i < R; i++) {
+      out(i, i) = 1;
+    }
+    return out;
+  }
+
+  /**
+   * A square matrix with the given values on its diagonal.
+   */
+  static FixedMatrix diagonal(std::initializer_list<double> ivalues) {
+    static_assert(R == C, "Only a square matrix has a diagonal");
+    FixedMatrix out;
+    std::size_t i = 0;
+    for (const double value : ivalues) {
+      if (i >= R) {
+        break;
+      }
+      out(i, i) = value;
+      i++;
+    }
+    return out;
+  }
+
+  double &operator()(const std::size_t irow, const std::size_t icol) {
+    return data[irow * C + icol];
+  }
+
+  double operator()(const std::size_t irow, const std::size_t icol) const {
+    return data[irow * C + icol];
+  }
+
+  /**
+   * Element access for vectors, which have one column.
+   */
+  double &operator[](const std::size_t i) {
+    static_assert(C == 1, "Use (row, column) to index a matrix");
+    return data[i];
+  }
+
+  double operator[](const std::size_t i) const {
+    static_assert(C == 1, "Use (row, column) to index a matrix");
+    return data[i];
+  }
+
+  static constexpr std::size_t rows() {
+    return R;
+  }
+
+  static constexpr std::size_t cols() {
+    return C;
+  }
+
+  FixedMatrix<C, R> transpose() const {
+    FixedMatrix<C, R> out;
+    for (std::size_t i = 0; i < R; i++) {
+      for (std::size_t j = 0; j < C; j++) {
+        out(j, i) = (*this)(i, j);
+      }
+    }
+    return out;
+  }
+
+  FixedMatrix &operator+=(const FixedMatrix &rhs) {
+    for (std::size_t i = 0; i < R * C; i++) {
+      data[i] += rhs.data[i];
+    }
+    return *this;
+  }
+
+  FixedMatrix &operator-=(const FixedMatrix &rhs) {
+    for (std::size_t i = 0; i < R * C; i++) {
+      data[i] -= rhs.data[i];
+    }
+    return *this;
+  }
+
+  FixedMatrix &operator*=(const double rhs) {
+    for (std::size_t i = 0; i < R * C; i++) {
+      data[i] *= rhs;
+    }
+    return *this;
+  }
+
+  friend FixedMatrix operator+(FixedMatrix lhs, const FixedMatrix &rhs) {
+    return lhs += rhs;
+  }
+
+  friend FixedMatrix operator-(FixedMatrix lhs, const FixedMatrix &rhs) {
+    return lhs -= rhs;
+  }
+
+  friend FixedMatrix operator*(FixedMatrix lhs, const double rhs) {
+    return lhs *= rhs;
+  }
+
+  friend FixedMatrix operator*(const double lhs, FixedMatrix rhs) {
+    return rhs *= lhs;
+  }
+
+  template <std::size_t K>
+  friend FixedMatrix<R, K> operator*(const FixedMatrix &lhs, const FixedMatrix<C, K> &rhs) {
+    FixedMatrix<R, K> out;
+    for (std::size_t i = 0; i < R; i++) {
+      for (std::size_t k = 0; k < C; k++) {
+        const double a = lhs(i, k);
+        for (std::size_t j = 0; j < K; j++) {
+          out(i, j) += a * rhs(k, j);
+        }
+      }
+    }
+    return out;
+  }
+
+  bool operator==(const FixedMatrix &rhs) const {
+    return data == rhs.data;
+  }
+
+  bool operator!=(const FixedMatrix &rhs) const {
+    return data != rhs.data;
+  }
+
+  std::array<double, R * C> data{};
+};
+
+/**
+ * A column vector with its size fixed at compile time.
+ */
+template <std::size_t N> using FixedVector = FixedMatrix<N, 1>;
+
+/**
+ * Solves `A * X = B` for X, where A is symmetric and positive definite, such as a covariance. A
+ * is factored as `L * L^T` (Cholesky decomposition), which needs no pivoting and is stable for
+ * this kind of matrix.
+ *
+ * @param iA The symmetric, positive definite matrix. Only its lower triangle is used.
+ * @param iB The right hand side.
+ * @param oX Where to write the solution. It is not changed if the solve fails.
+ * @return Whether A was positive definite, so the solve succeeded.
+ */
+template <std::size_t N, std::size_t M>
+bool choleskySolve(const FixedMatrix<N, N> &iA,
+                   const FixedMatrix<N, M> &iB,
+                   FixedMatrix<N, M> &oX) {
+  FixedMatrix<N, N> L;
+  for (std::size_t j = 0; j < N; j++) {
+    double diag = iA(j, j);
+    for (std::size_t k = 0; k < j; k++) {
+      diag -= L(j, k) * L(j, k);
+    }
+    if (!(diag > 0)) {
+      return false;
+    }
+    L(j, j) = std::sqrt(diag);
+
+    for (std::size_t i = j + 1; i < N; i++) {
+      double value = iA(i, j);
+      for (std::size_t k = 0; k < j; k++) {
+        value -= L(i, k) * L(j, k);
+      }
+      L(i, j) = value / L(j, j);
+    }
+  }
+
+  // Forward substitution for L * Y = B, then back substitution for L^T * X = Y
+  FixedMatrix<N, M> X = iB;
+  for (std::size_t c = 0; c < M; c++) {
+    for (std::size_t i = 0; i < N; i++) {
+      double value = X(i, c);
+      for (std::size_t k = 0; k < i; k++) {
+        value -= L(i, k) * X(k, c);
+      }
+      X(i, c) = value / L(i, i);
+    }
+    for (std::size_t i = N; i-- > 0;) {
+      double value = X(i, c);
+      for (std::size_t k = i + 1; k < N; k++) {
+        value -= L(k, i) * X(k, c);
+      }
+      X(i, c) = value / L(i, i);
+    }
+  }
+
+  oX = X;
+  return true;
+}
+} // namespace okapi
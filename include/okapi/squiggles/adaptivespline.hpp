@@ -0,0 +1,228 @@
+/**
+ * Copyright 2020 Jonathan Bayless
+ *
+ * Use of this source code is governed by an MIT-style license that can be found
+ * in the LICENSE file or at https://opensource.org/licenses/MIT.
+ */
+#ifndef _SQUIGGLES_ADAPTIVE_SPLINE_HPP_
+#define _SQUIGGLES_ADAPTIVE_SPLINE_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "spline.hpp"
+
+namespace squiggles {
+/**
+ * Limits for AdaptiveSplineGenerator. Tighter limits give a more accurate
+ * raw path at the cost of more points. Distances are in meters.
+ */
+struct SamplingOptions {
+  /**
+   * The furthest the straight line between two samples may be from the
+   * spline between them.
+   */
+  double max_chordal_error = 0.0005;
+
+  /**
+   * The largest change in curvature (1 / meters) allowed between two
+   * samples.
+   */
+  double max_curvature_change = 0.25;
+
+  /**
+   * The longest allowed distance between two samples, even on a straight.
+   */
+  double max_spacing = 0.15;
+
+  /**
+   * Intervals shorter than this are never split further.
+   */
+  double min_spacing = 0.002;
+
+  /**
+   * The deepest an interval of the spline is bisected.
+   */
+  int max_depth = 16;
+};
+
+/**
+ * A SplineGenerator that samples each quintic adaptively instead of at a
+ * fixed step of the spline parameter. Intervals are bisected wherever the
+ * chord strays too far from the curve or the curvature changes too much, so
+ * straights get a handful of samples and tight turns get many.
+ *
+ * The samples replace the raw path of gen_raw_path and are then
+ * parameterized as usual, so the profile is still produced every dt seconds
+ * for the followers.
+ */
+class AdaptiveSplineGenerator : public SplineGenerator {
+  public:
+  AdaptiveSplineGenerator(Constraints iconstraints,
+                          std::shared_ptr<PhysicalModel> imodel =
+                            std::make_shared<PassthroughModel>(),
+                          double idt = 0.1,
+                          SamplingOptions ioptions = SamplingOptions())
+    : SplineGenerator(iconstraints, imodel, idt), options(ioptions) {}
+
+  std::vector<ProfilePoint> generate_adaptive(std::vector<Pose> iwaypoints) {
+    std::vector<ControlVector> vectors;
+    vectors.reserve(iwaypoints.size());
+    for (const auto& p : iwaypoints) {
+      vectors.emplace_back(p);
+    }
+    return generate_adaptive(vectors);
+  }
+
+  std::vector<ProfilePoint>
+  generate_adaptive(std::vector<ControlVector> iwaypoints) {
+    if (iwaypoints.size() < 2) {
+      return {};
+    }
+    std::vector<GeneratedPoint> raw_path;
+    for (std::size_t i = 0; i + 1 < iwaypoints.size(); ++i) {
+      auto segment = gen_adaptive_raw_path(iwaypoints[i], iwaypoints[i + 1]);
+      // The first sample of a segment is the last sample of the one before
+      raw_path.insert(raw_path.end(),
+                      segment.begin() + (raw_path.empty() ? 0 : 1),
+                      segment.end());
+    }
+    const auto& start = iwaypoints.front();
+    const auto& end = iwaypoints.back();
+    return parameterize(start,
+                        end,
+                        raw_path,
+                        std::isnan(start.vel) ? 0.0 : start.vel,
+                        std::isnan(end.vel) ? 0.0 : end.vel,
+                        0.0);
+  }
+
+  /**
+   * Samples the spline between two control vectors adaptively.
+   *
+   * The spline's duration is the shortest whole number of seconds between
+   * T_MIN and T_MAX that keeps its acceleration and jerk within the
+   * constraints, like the duration search of gen_raw_path. Waypoints without
+   * a velocity use K_DEFAULT_VEL rather than the gradient descent of
+   * gen_raw_path, which scores candidates on fixed-step samples.
+   */
+  std::vector<GeneratedPoint> gen_adaptive_raw_path(ControlVector start,
+                                                    ControlVector end) {
+    if (std::isnan(start.vel)) {
+      start.vel = K_DEFAULT_VEL;
+    }
+    if (std::isnan(end.vel)) {
+      end.vel = K_DEFAULT_VEL;
+    }
+
+    double duration = T_MAX;
+    for (int t = T_MIN; t <= T_MAX; ++t) {
+      if (within_constraints(
+            get_x_spline(start, end, t), get_y_spline(start, end, t), t)) {
+        duration = t;
+        break;
+      }
+    }
+
+    Curve curve{get_x_spline(start, end, duration),
+                get_y_spline(start, end, duration)};
+    std::vector<GeneratedPoint> out;
+    Sample first = curve.sample(0);
+    Sample last = curve.sample(duration);
+    out.push_back(first.point());
+    subdivide(curve, 0, first, duration, last, 0, out);
+    return out;
+  }
+
+  SamplingOptions options;
+
+  protected:
+  struct Sample {
+    double x, y, dx, dy, ddx, ddy;
+
+    double curvature() const {
+      const double speed2 = dx * dx + dy * dy;
+      return speed2 < K_EPSILON ? 0.0
+                                : (dx * ddy - dy * ddx) / std::pow(speed2, 1.5);
+    }
+
+    GeneratedPoint point() const {
+      return GeneratedPoint(Pose(x, y, std::atan2(dy, dx)), curvature());
+    }
+  };
+
+  struct Curve {
+    QuinticPolynomial x;
+    QuinticPolynomial y;
+
+    Sample sample(double t) const {
+      QuinticPolynomial::Sample sx, sy;
+      QuinticPolynomial::calc_batch_xy(x, y, &t, 1, &sx, &sy);
+      return {sx.p, sy.p, sx.v, sy.v, sx.a, sy.a};
+    }
+  };
+
+  /**
+   * Checks the spline's own acceleration and jerk, the same quantities the
+   * duration search of the fixed sampler limits.
+   */
+  bool within_constraints(QuinticPolynomial x, QuinticPolynomial y, double t) {
+    const int steps = 50;
+    for (int i = 0; i <= steps; ++i) {
+      const double s = t * i / steps;
+      const double accel = std::hypot(x.calc_second_derivative(s),
+                                      y.calc_second_derivative(s));
+      const double jerk =
+        std::hypot(x.calc_third_derivative(s), y.calc_third_derivative(s));
+      if (accel > constraints.max_accel || jerk > constraints.max_jerk) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Appends the samples after t0 up to and including t1.
+   */
+  void subdivide(Curve& curve,
+                 double t0,
+                 const Sample& s0,
+                 double t1,
+                 const Sample& s1,
+                 int depth,
+                 std::vector<GeneratedPoint>& out) {
+    const double tm = (t0 + t1) / 2;
+    const Sample sm = curve.sample(tm);
+
+    const double chord = std::hypot(s1.x - s0.x, s1.y - s0.y);
+    // Distance from the middle of the curve to the chord, or to the first
+    // sample if the chord has no length
+    const double error =
+      chord < K_EPSILON
+        ? std::hypot(sm.x - s0.x, sm.y - s0.y)
+        : std::fabs((s1.x - s0.x) * (s0.y - sm.y) -
+                    (s0.x - sm.x) * (s1.y - s0.y)) /
+            chord;
+    const double k0 = s0.curvature();
+    const double km = sm.curvature();
+    const double k1 = s1.curvature();
+    const double curvature_change =
+      std::max(std::fabs(km - k0), std::fabs(k1 - km));
+
+    const bool split =
+      depth < options.max_depth && chord > options.min_spacing &&
+      (chord > options.max_spacing || error > options.max_chordal_error ||
+       curvature_change > options.max_curvature_change);
+    if (split) {
+      subdivide(curve, t0, s0, tm, sm, depth + 1, out);
+      subdivide(curve, tm, sm, t1, s1, depth + 1, out);
+    } else {
+      out.push_back(s1.point());
+    }
+  }
+};
+} // namespace squiggles
+
+#endif
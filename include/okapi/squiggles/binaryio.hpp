@@ -0,0 +1,270 @@
+/**
+ * Copyright 2020 Jonathan Bayless
+ *
+ * Use of this source code is governed by an MIT-style license that can be found
+ * in the LICENSE file or at https://opensource.org/licenses/MIT.
+ */
+#ifndef _SQUIGGLES_BINARY_IO_HPP_
+#define _SQUIGGLES_BINARY_IO_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <vector>
+
+#include "geometry/profilepoint.hpp"
+
+namespace squiggles {
+/**
+ * A compact, versioned alternative to the CSV format of serialize_path.
+ *
+ * A file is a fixed BinaryPathHeader followed by one column per field (x, y,
+ * yaw, vel, accel, jerk, curvature, time, then each wheel velocity). Every
+ * value is stored as a 16 bit fixed-point number using the scale recorded for
+ * its column in the header, so a value is off by at most half of that
+ * column's scale. A CRC-32 of the header (with its crc field zeroed) and the
+ * column data guards against truncated or corrupted files, including a
+ * damaged scale or count. All fields are little-endian, which matches both the
+ * V5 brain and x86 hosts.
+ *
+ * Version 1 files, whose CRC covered only the column data, are not read.
+ */
+struct BinaryPathHeader {
+  static constexpr std::uint32_t MAGIC = 0x50425153; // "SQBP"
+  static constexpr std::uint16_t VERSION = 2;
+  static constexpr std::size_t BASE_COLUMNS = 8;
+  static constexpr std::size_t MAX_WHEELS = 4;
+  static constexpr std::size_t MAX_COLUMNS = BASE_COLUMNS + MAX_WHEELS;
+
+  std::uint32_t magic;
+  std::uint16_t version;
+  std::uint16_t wheel_count;
+  std::uint32_t point_count;
+  std::uint32_t crc;
+  float scale[MAX_COLUMNS];
+
+  std::size_t columns() const {
+    return BASE_COLUMNS + wheel_count;
+  }
+
+  std::size_t payload_values() const {
+    return columns() * point_count;
+  }
+};
+static_assert(sizeof(BinaryPathHeader) == 64,
+              "BinaryPathHeader must have the same layout on every target");
+
+namespace detail {
+constexpr std::array<std::uint32_t, 256> make_crc_table() {
+  std::array<std::uint32_t, 256> table{};
+  for (std::uint32_t i = 0; i < 256; ++i) {
+    std::uint32_t c = i;
+    for (int k = 0; k < 8; ++k) {
+      c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+    }
+    table[i] = c;
+  }
+  return table;
+}
+
+inline constexpr std::array<std::uint32_t, 256> crc_table = make_crc_table();
+
+/**
+ * The standard (zlib) CRC-32 of a block of memory. Pass the CRC of the
+ * preceding blocks as crc to continue it over several blocks.
+ */
+inline std::uint32_t
+crc32(const void* data, std::size_t size, std::uint32_t crc = 0) {
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  std::uint32_t c = crc ^ 0xFFFFFFFFu;
+  for (std::size_t i = 0; i < size; ++i) {
+    c = crc_table[(c ^ bytes[i]) & 0xFF] ^ (c >> 8);
+  }
+  return c ^ 0xFFFFFFFFu;
+}
+
+inline double column_value(const ProfilePoint& p, std::size_t column) {
+  switch (column) {
+    case 0: return p.vector.pose.x;
+    case 1: return p.vector.pose.y;
+    case 2: return p.vector.pose.yaw;
+    case 3: return p.vector.vel;
+    case 4: return p.vector.accel;
+    case 5: return p.vector.jerk;
+    case 6: return p.curvature;
+    case 7: return p.time;
+    default: return p.wheel_velocities[column - BinaryPathHeader::BASE_COLUMNS];
+  }
+}
+
+/**
+ * The CRC of a header with its crc field taken as zero, followed by the
+ * column data.
+ */
+inline std::uint32_t path_crc(BinaryPathHeader header,
+                              const std::vector<std::int16_t>& payload) {
+  header.crc = 0;
+  return crc32(payload.data(),
+               payload.size() * sizeof(std::int16_t),
+               crc32(&header, sizeof(header)));
+}
+
+/**
+ * The number of bytes between the current position of a file and its end, or
+ * std::nullopt if the file can't seek.
+ */
+inline std::optional<long> remaining_bytes(std::FILE* in) {
+  const long start = std::ftell(in);
+  if (start < 0 || std::fseek(in, 0, SEEK_END) != 0) {
+    return std::nullopt;
+  }
+  const long end = std::ftell(in);
+  if (std::fseek(in, start, SEEK_SET) != 0 || end < start) {
+    return std::nullopt;
+  }
+  return end - start;
+}
+} // namespace detail
+
+/**
+ * Writes the path in the binary format.
+ *
+ * @param out The file to write to, opened in binary mode.
+ * @param path The path to serialize. Only the first
+ *             BinaryPathHeader::MAX_WHEELS wheel velocities are kept.
+ *
+ * @return 0 if the path was serialized succesfully or -1 if an error occurred,
+ *         including a value that is NaN or infinite. Nothing is written if a
+ *         value is not finite.
+ */
+inline int serialize_binary_path(std::FILE* out,
+                                 const std::vector<ProfilePoint>& path) {
+  BinaryPathHeader header{};
+  header.magic = BinaryPathHeader::MAGIC;
+  header.version = BinaryPathHeader::VERSION;
+  header.point_count = static_cast<std::uint32_t>(path.size());
+  header.wheel_count =
+    path.empty() ? 0
+                 : static_cast<std::uint16_t>(
+                     std::min(path[0].wheel_velocities.size(),
+                              BinaryPathHeader::MAX_WHEELS));
+
+  const std::size_t columns = header.columns();
+  const std::size_t n = path.size();
+  std::vector<std::int16_t> payload(columns * n);
+
+  for (std::size_t c = 0; c < columns; ++c) {
+    double max = 0;
+    for (const auto& p : path) {
+      const double value = detail::column_value(p, c);
+      if (!std::isfinite(value)) {
+        return -1;
+      }
+      max = std::max(max, std::fabs(value));
+    }
+    // Round the scale to float first so the reader decodes with exactly the
+    // value that was used to encode
+    const float scale = max > 0 ? static_cast<float>(max / 32767.0) : 1.0f;
+    header.scale[c] = scale;
+    for (std::size_t i = 0; i < n; ++i) {
+      const double q = std::round(detail::column_value(path[i], c) / scale);
+      payload[c * n + i] =
+        static_cast<std::int16_t>(std::max(-32767.0, std::min(32767.0, q)));
+    }
+  }
+
+  header.crc = detail::path_crc(header, payload);
+
+  if (std::fwrite(&header, sizeof(header), 1, out) != 1) {
+    return -1;
+  }
+  if (!payload.empty() &&
+      std::fwrite(payload.data(), sizeof(std::int16_t), payload.size(), out) !=
+        payload.size()) {
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * Reads the header and raw column data of a binary path with one bulk read.
+ *
+ * @param in The file to read from, opened in binary mode. It must be able to
+ *           seek, so the point count can be checked against the file's size
+ *           before any memory is allocated for it.
+ * @param buffer Storage for the column data. It is only grown if its capacity
+ *               is too small, so a buffer reserved ahead of time makes this
+ *               allocation-free.
+ *
+ * @return The header, or std::nullopt if the file is not a valid binary path.
+ */
+inline std::optional<BinaryPathHeader>
+read_binary_path(std::FILE* in, std::vector<std::int16_t>& buffer) {
+  BinaryPathHeader header;
+  if (std::fread(&header, sizeof(header), 1, in) != 1 ||
+      header.magic != BinaryPathHeader::MAGIC ||
+      header.version != BinaryPathHeader::VERSION ||
+      header.wheel_count > BinaryPathHeader::MAX_WHEELS) {
+    return std::nullopt;
+  }
+
+  // A damaged point count could otherwise ask for far more memory than the
+  // brain has before the read fails
+  const auto remaining = detail::remaining_bytes(in);
+  if (!remaining || static_cast<std::uint64_t>(*remaining) / sizeof(std::int16_t) <
+                      static_cast<std::uint64_t>(header.columns()) * header.point_count) {
+    return std::nullopt;
+  }
+
+  buffer.resize(header.payload_values());
+  if (std::fread(buffer.data(), sizeof(std::int16_t), buffer.size(), in) !=
+        buffer.size() ||
+      detail::path_crc(header, buffer) != header.crc) {
+    return std::nullopt;
+  }
+  return header;
+}
+
+/**
+ * Converts binary path data into a path.
+ *
+ * @param in The file containing the binary data, opened in binary mode.
+ *
+ * @return The path specified by the binary data or std::nullopt if
+ *         de-serializing the path was unsuccessful.
+ */
+inline std::optional<std::vector<ProfilePoint>>
+deserialize_binary_path(std::FILE* in) {
+  std::vector<std::int16_t> buffer;
+  const auto header = read_binary_path(in, buffer);
+  if (!header) {
+    return std::nullopt;
+  }
+
+  const std::size_t n = header->point_count;
+  const auto value = [&](std::size_t c, std::size_t i) {
+    return static_cast<double>(buffer[c * n + i]) * header->scale[c];
+  };
+
+  std::vector<ProfilePoint> path;
+  path.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    std::vector<double> wheels(header->wheel_count);
+    for (std::size_t w = 0; w < wheels.size(); ++w) {
+      wheels[w] = value(BinaryPathHeader::BASE_COLUMNS + w, i);
+    }
+    path.emplace_back(
+      ControlVector(
+        Pose(value(0, i), value(1, i), value(2, i)), value(3, i), value(4, i), value(5, i)),
+      wheels,
+      value(6, i),
+      value(7, i));
+  }
+  return path;
+}
+} // namespace squiggles
+
+#endif
@@ -0,0 +1,105 @@
+/**
+ * Copyright 2020 Jonathan Bayless
+ *
+ * Use of this source code is governed by an MIT-style license that can be found
+ * in the LICENSE file or at https://opensource.org/licenses/MIT.
+ */
+#ifndef _GEOMETRY_PACKED_PROFILE_HPP_
+#define _GEOMETRY_PACKED_PROFILE_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "geometry/profilepoint.hpp"
+
+namespace squiggles {
+/**
+ * A ProfilePoint stored as plain single precision data so that it can live in
+ * a read-only table (for example one generated ahead of time by
+ * tools/pathgen.cpp) without any construction at startup.
+ */
+struct PackedProfilePoint {
+  static constexpr std::size_t MAX_WHEELS = 4;
+
+  float x;
+  float y;
+  float yaw;
+  float vel;
+  float accel;
+  float jerk;
+  float curvature;
+  float time;
+  float wheel_velocities[MAX_WHEELS];
+
+  /**
+   * Packs a ProfilePoint. Wheel velocities past MAX_WHEELS are dropped.
+   */
+  static PackedProfilePoint pack(const ProfilePoint& p) {
+    PackedProfilePoint out{float(p.vector.pose.x),
+                           float(p.vector.pose.y),
+                           float(p.vector.pose.yaw),
+                           float(p.vector.vel),
+                           float(p.vector.accel),
+                           float(p.vector.jerk),
+                           float(p.curvature),
+                           float(p.time),
+                           {0, 0, 0, 0}};
+    for (std::size_t i = 0; i < p.wheel_velocities.size() && i < MAX_WHEELS;
+         ++i) {
+      out.wheel_velocities[i] = float(p.wheel_velocities[i]);
+    }
+    return out;
+  }
+
+  /**
+   * Expands the packed data back into a ProfilePoint with the given number of
+   * wheels. Only MAX_WHEELS wheel velocities are stored, so a larger count is
+   * clamped to MAX_WHEELS.
+   */
+  ProfilePoint unpack(std::size_t wheel_count) const {
+    return ProfilePoint(
+      ControlVector(Pose(x, y, yaw), vel, accel, jerk),
+      std::vector<double>(wheel_velocities,
+                          wheel_velocities + std::min(wheel_count, MAX_WHEELS)),
+      curvature,
+      time);
+  }
+};
+
+/**
+ * A read-only view over a table of packed profile points.
+ */
+struct PackedPath {
+  const PackedProfilePoint* points;
+  std::size_t size;
+  std::size_t wheel_count;
+
+  constexpr const PackedProfilePoint& operator[](std::size_t i) const {
+    return points[i];
+  }
+
+  constexpr const PackedProfilePoint* begin() const {
+    return points;
+  }
+
+  constexpr const PackedProfilePoint* end() const {
+    return points + size;
+  }
+
+  /**
+   * Expands the whole path into the representation returned by
+   * SplineGenerator::generate.
+   */
+  std::vector<ProfilePoint> unpack() const {
+    std::vector<ProfilePoint> out;
+    out.reserve(size);
+    for (const auto& p : *this) {
+      out.push_back(p.unpack(wheel_count));
+    }
+    return out;
+  }
+};
+} // namespace squiggles
+
+#endif
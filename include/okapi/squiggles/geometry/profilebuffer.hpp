@@ -0,0 +1,230 @@
+/**
+ * Copyright 2020 Jonathan Bayless
+ *
+ * Use of this source code is governed by an MIT-style license that can be found
+ * in the LICENSE file or at https://opensource.org/licenses/MIT.
+ */
+#ifndef _GEOMETRY_PROFILE_BUFFER_HPP_
+#define _GEOMETRY_PROFILE_BUFFER_HPP_
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "geometry/profilepoint.hpp"
+
+namespace squiggles {
+/**
+ * Stores a motion profile as one contiguous column per field instead of a
+ * vector of ProfilePoints. The number of wheels is fixed at compile time, so
+ * a point does not own a heap allocation of its own: once the buffer has
+ * reserved space for a path, filling and reading it never allocates.
+ *
+ * Points are read out as Point, which has the same fields as ProfilePoint
+ * and converts to one when an existing API needs it.
+ *
+ * @tparam WHEELS The number of wheel velocities stored for each point, 2 for
+ *                a TankModel.
+ */
+template <std::size_t WHEELS = 2> class ProfileBuffer {
+  public:
+  enum Column : std::size_t {
+    X,
+    Y,
+    YAW,
+    VEL,
+    ACCEL,
+    JERK,
+    CURVATURE,
+    TIME,
+    WHEEL_0,
+  };
+
+  static constexpr std::size_t COLUMNS = WHEEL_0 + WHEELS;
+
+  /**
+   * A copy of one point in the buffer, with the same fields as ProfilePoint.
+   * The wheel velocities are held inline, so copying a point never
+   * allocates.
+   */
+  struct Point {
+    ControlVector vector;
+    std::array<double, WHEELS> wheel_velocities{};
+    double curvature = 0;
+    double time = 0;
+
+    /**
+     * Copies the point out as a ProfilePoint. This allocates the point's
+     * wheel velocity vector, so it is meant for interoperating with existing
+     * code rather than for use in a control loop.
+     */
+    ProfilePoint to_point() const {
+      return ProfilePoint(vector,
+                          std::vector<double>(wheel_velocities.begin(),
+                                              wheel_velocities.end()),
+                          curvature,
+                          time);
+    }
+
+    operator ProfilePoint() const {
+      return to_point();
+    }
+
+    std::string to_string() const {
+      return to_point().to_string();
+    }
+  };
+
+  class const_iterator {
+    public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Point;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = Point;
+
+    const_iterator(const ProfileBuffer& ibuffer, std::size_t iindex)
+      : buffer(&ibuffer), index(iindex) {}
+
+    Point operator*() const {
+      return (*buffer)[index];
+    }
+
+    const_iterator& operator++() {
+      ++index;
+      return *this;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return index == other.index && buffer == other.buffer;
+    }
+
+    bool operator!=(const const_iterator& other) const {
+      return !(*this == other);
+    }
+
+    private:
+    const ProfileBuffer* buffer;
+    std::size_t index;
+  };
+
+  ProfileBuffer() = default;
+
+  /**
+   * Copies a path returned by SplineGenerator::generate. Wheel velocities
+   * past WHEELS are dropped and missing ones are stored as zero.
+   */
+  explicit ProfileBuffer(const std::vector<ProfilePoint>& path) {
+    reserve(path.size());
+    for (const auto& p : path) {
+      push_back(p);
+    }
+  }
+
+  void reserve(std::size_t n) {
+    for (auto& column : columns) {
+      column.reserve(n);
+    }
+  }
+
+  void clear() {
+    for (auto& column : columns) {
+      column.clear();
+    }
+  }
+
+  std::size_t size() const {
+    return columns[TIME].size();
+  }
+
+  bool empty() const {
+    return columns[TIME].empty();
+  }
+
+  void push_back(const ControlVector& vector,
+                 const std::array<double, WHEELS>& wheel_velocities,
+                 double curvature,
+                 double time) {
+    columns[X].push_back(vector.pose.x);
+    columns[Y].push_back(vector.pose.y);
+    columns[YAW].push_back(vector.pose.yaw);
+    columns[VEL].push_back(vector.vel);
+    columns[ACCEL].push_back(vector.accel);
+    columns[JERK].push_back(vector.jerk);
+    columns[CURVATURE].push_back(curvature);
+    columns[TIME].push_back(time);
+    for (std::size_t w = 0; w < WHEELS; ++w) {
+      columns[WHEEL_0 + w].push_back(wheel_velocities[w]);
+    }
+  }
+
+  void push_back(const ProfilePoint& p) {
+    std::array<double, WHEELS> wheels{};
+    for (std::size_t w = 0; w < WHEELS && w < p.wheel_velocities.size(); ++w) {
+      wheels[w] = p.wheel_velocities[w];
+    }
+    push_back(p.vector, wheels, p.curvature, p.time);
+  }
+
+  Point operator[](std::size_t i) const {
+    Point out{ControlVector(Pose(columns[X][i], columns[Y][i], columns[YAW][i]),
+                            columns[VEL][i],
+                            columns[ACCEL][i],
+                            columns[JERK][i]),
+              {},
+              columns[CURVATURE][i],
+              columns[TIME][i]};
+    for (std::size_t w = 0; w < WHEELS; ++w) {
+      out.wheel_velocities[w] = columns[WHEEL_0 + w][i];
+    }
+    return out;
+  }
+
+  Point front() const {
+    return (*this)[0];
+  }
+
+  Point back() const {
+    return (*this)[size() - 1];
+  }
+
+  const_iterator begin() const {
+    return const_iterator(*this, 0);
+  }
+
+  const_iterator end() const {
+    return const_iterator(*this, size());
+  }
+
+  /**
+   * Direct access to one column, for loops that only need a few fields.
+   */
+  const double* column(Column c) const {
+    return columns[c].data();
+  }
+
+  double* column(Column c) {
+    return columns[c].data();
+  }
+
+  /**
+   * Copies the buffer out in the representation returned by
+   * SplineGenerator::generate.
+   */
+  std::vector<ProfilePoint> to_points() const {
+    std::vector<ProfilePoint> out;
+    out.reserve(size());
+    for (const auto p : *this) {
+      out.push_back(p.to_point());
+    }
+    return out;
+  }
+
+  private:
+  std::array<std::vector<double>, COLUMNS> columns;
+};
+} // namespace squiggles
+
+#endif
@@ -0,0 +1,160 @@
+/**
+ * Copyright 2020 Jonathan Bayless
+ *
+ * Use of this source code is governed by an MIT-style license that can be found
+ * in the LICENSE file or at https://opensource.org/licenses/MIT.
+ */
+#ifndef _GEOMETRY_UNIFORM_PROFILE_HPP_
+#define _GEOMETRY_UNIFORM_PROFILE_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "geometry/profilebuffer.hpp"
+
+namespace squiggles {
+/**
+ * A profile resampled onto a uniform time grid, so the sample for any time is
+ * found by direct indexing instead of a search. Looking up a time costs the
+ * same no matter how long the path is and never allocates.
+ *
+ * @tparam WHEELS The number of wheel velocities stored for each point.
+ */
+template <std::size_t WHEELS = 2> class UniformProfile {
+  public:
+  /**
+   * The state at one time, with the same fields as ProfilePoint and the
+   * wheel velocities held inline.
+   */
+  using Sample = typename ProfileBuffer<WHEELS>::Point;
+
+  UniformProfile() = default;
+
+  /**
+   * Resamples a path every iperiod seconds, interpolating linearly between
+   * its points. The path's points do not need to be evenly spaced in time.
+   *
+   * @param path The path, in increasing time order
+   * @param iperiod The time between samples in seconds, for example the 10 ms
+   *                loop of AsyncMotionProfileController
+   */
+  UniformProfile(const std::vector<ProfilePoint>& path, double iperiod)
+    : period(iperiod) {
+    if (path.empty()) {
+      return;
+    }
+    start = path.front().time;
+    const double duration = path.back().time - start;
+    const std::size_t count =
+      static_cast<std::size_t>(std::ceil(duration / period - 1e-9)) + 1;
+    samples.reserve(count);
+
+    std::size_t i = 0;
+    for (std::size_t k = 0; k < count; ++k) {
+      // The last sample can land past the end of the path, where it holds the
+      // path's final state
+      const double grid = start + k * period;
+      const double t = std::min(grid, path.back().time);
+      while (i + 1 < path.size() && path[i + 1].time < t) {
+        ++i;
+      }
+      const ProfilePoint& a = path[i];
+      const ProfilePoint& b = path[std::min(i + 1, path.size() - 1)];
+      const double span = b.time - a.time;
+      const double f = span > 0 ? std::clamp((t - a.time) / span, 0.0, 1.0) : 0.0;
+
+      std::array<double, WHEELS> wheels{};
+      for (std::size_t w = 0; w < WHEELS; ++w) {
+        const double wa = w < a.wheel_velocities.size() ? a.wheel_velocities[w] : 0;
+        const double wb = w < b.wheel_velocities.size() ? b.wheel_velocities[w] : 0;
+        wheels[w] = wa + (wb - wa) * f;
+      }
+      samples.push_back(lerp_vector(a.vector, b.vector, f),
+                        wheels,
+                        a.curvature + (b.curvature - a.curvature) * f,
+                        grid);
+    }
+  }
+
+  std::size_t size() const {
+    return samples.size();
+  }
+
+  bool empty() const {
+    return samples.empty();
+  }
+
+  double duration() const {
+    return empty() ? 0.0 : (size() - 1) * period;
+  }
+
+  /**
+   * The index of the last sample at or before the given time, clamped to the
+   * profile.
+   */
+  std::size_t index(double t) const {
+    const double k = std::floor((t - start) / period);
+    if (!(k > 0) || empty()) {
+      return 0;
+    }
+    return std::min(static_cast<std::size_t>(k), size() - 1);
+  }
+
+  /**
+   * The state at the given time, interpolated between the two samples around
+   * it. Times outside the profile give its first or last sample. The profile
+   * must not be empty.
+   */
+  Sample at(double t) const {
+    const std::size_t i = index(t);
+    const std::size_t j = std::min(i + 1, size() - 1);
+    const double f =
+      i == j ? 0.0 : std::clamp((t - start) / period - i, 0.0, 1.0);
+    const Sample a = samples[i];
+    const Sample b = samples[j];
+
+    Sample out{lerp_vector(a.vector, b.vector, f),
+               {},
+               a.curvature + (b.curvature - a.curvature) * f,
+               std::clamp(t, start, start + duration())};
+    for (std::size_t w = 0; w < WHEELS; ++w) {
+      out.wheel_velocities[w] =
+        a.wheel_velocities[w] + (b.wheel_velocities[w] - a.wheel_velocities[w]) * f;
+    }
+    return out;
+  }
+
+  /**
+   * The k-th sample, without interpolation.
+   */
+  Sample operator[](std::size_t k) const {
+    return samples[k];
+  }
+
+  const ProfileBuffer<WHEELS>& buffer() const {
+    return samples;
+  }
+
+  double period = 0.01;
+  double start = 0;
+
+  private:
+  static ControlVector
+  lerp_vector(const ControlVector& a, const ControlVector& b, double f) {
+    const double dyaw = std::remainder(b.pose.yaw - a.pose.yaw, 2 * M_PI);
+    return ControlVector(Pose(a.pose.x + (b.pose.x - a.pose.x) * f,
+                              a.pose.y + (b.pose.y - a.pose.y) * f,
+                              a.pose.yaw + dyaw * f),
+                         a.vel + (b.vel - a.vel) * f,
+                         a.accel + (b.accel - a.accel) * f,
+                         a.jerk + (b.jerk - a.jerk) * f);
+  }
+
+  ProfileBuffer<WHEELS> samples;
+};
+} // namespace squiggles
+
+#endif
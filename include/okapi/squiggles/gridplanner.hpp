@@ -0,0 +1,381 @@
+/**
+ * Copyright 2020 Jonathan Bayless
+ *
+ * Use of this source code is governed by an MIT-style license that can be found
+ * in the LICENSE file or at https://opensource.org/licenses/MIT.
+ */
+#ifndef _SQUIGGLES_GRID_PLANNER_HPP_
+#define _SQUIGGLES_GRID_PLANNER_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "geometry/pose.hpp"
+#include "geometry/profilepoint.hpp"
+#include "spline.hpp"
+
+namespace squiggles {
+/**
+ * A map of the field as square cells that are either free or blocked.
+ * Coordinates are in meters with the origin at the corner of cell (0, 0).
+ */
+class OccupancyGrid {
+  public:
+  /**
+   * @param iwidth The size of the field along x in meters.
+   * @param iheight The size of the field along y in meters.
+   * @param iresolution The side of one cell in meters.
+   */
+  OccupancyGrid(double iwidth, double iheight, double iresolution)
+    : resolution(iresolution),
+      columns(static_cast<int>(std::ceil(iwidth / iresolution))),
+      rows(static_cast<int>(std::ceil(iheight / iresolution))),
+      cells(static_cast<std::size_t>(columns) * rows, 0) {}
+
+  /**
+   * Blocks every cell touching the rectangle between two corners.
+   */
+  void add_rectangle(double x0, double y0, double x1, double y1) {
+    const int c0 = std::max(0, cell(std::min(x0, x1)));
+    const int c1 = std::min(columns - 1, cell(std::max(x0, x1)));
+    const int r0 = std::max(0, cell(std::min(y0, y1)));
+    const int r1 = std::min(rows - 1, cell(std::max(y0, y1)));
+    for (int r = r0; r <= r1; ++r) {
+      for (int c = c0; c <= c1; ++c) {
+        cells[index(c, r)] = 1;
+      }
+    }
+  }
+
+  /**
+   * Blocks every cell whose center is within the circle.
+   */
+  void add_circle(double x, double y, double radius) {
+    const int c0 = std::max(0, cell(x - radius));
+    const int c1 = std::min(columns - 1, cell(x + radius));
+    const int r0 = std::max(0, cell(y - radius));
+    const int r1 = std::min(rows - 1, cell(y + radius));
+    for (int r = r0; r <= r1; ++r) {
+      for (int c = c0; c <= c1; ++c) {
+        if (std::hypot(center(c) - x, center(r) - y) <= radius) {
+          cells[index(c, r)] = 1;
+        }
+      }
+    }
+  }
+
+  /**
+   * Returns a copy with every obstacle grown by the given radius, so a robot
+   * of that radius can be planned for as a point. The edges of the field are
+   * grown as well.
+   */
+  OccupancyGrid inflated(double radius) const {
+    OccupancyGrid out(*this);
+    const int reach = static_cast<int>(std::ceil(radius / resolution));
+    for (int r = 0; r < rows; ++r) {
+      for (int c = 0; c < columns; ++c) {
+        const bool edge = std::min({center(c), center(r),
+                                    columns * resolution - center(c),
+                                    rows * resolution - center(r)}) < radius;
+        if (edge) {
+          out.cells[index(c, r)] = 1;
+        }
+        if (!cells[index(c, r)]) {
+          continue;
+        }
+        for (int dr = -reach; dr <= reach; ++dr) {
+          for (int dc = -reach; dc <= reach; ++dc) {
+            const int nc = c + dc;
+            const int nr = r + dr;
+            if (in_bounds(nc, nr) && std::hypot(dc, dr) * resolution <= radius) {
+              out.cells[index(nc, nr)] = 1;
+            }
+          }
+        }
+      }
+    }
+    return out;
+  }
+
+  bool in_bounds(int c, int r) const {
+    return c >= 0 && r >= 0 && c < columns && r < rows;
+  }
+
+  bool blocked(int c, int r) const {
+    return !in_bounds(c, r) || cells[index(c, r)];
+  }
+
+  bool blocked(double x, double y) const {
+    return blocked(cell(x), cell(y));
+  }
+
+  /**
+   * Whether the straight line between two points only crosses free cells.
+   * The line is checked every quarter cell.
+   */
+  bool line_free(double x0, double y0, double x1, double y1) const {
+    const double length = std::hypot(x1 - x0, y1 - y0);
+    const int steps = std::max(1, static_cast<int>(std::ceil(length / (resolution / 4))));
+    for (int i = 0; i <= steps; ++i) {
+      const double f = static_cast<double>(i) / steps;
+      if (blocked(x0 + (x1 - x0) * f, y0 + (y1 - y0) * f)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  int cell(double v) const {
+    return static_cast<int>(std::floor(v / resolution));
+  }
+
+  double center(int i) const {
+    return (i + 0.5) * resolution;
+  }
+
+  std::size_t index(int c, int r) const {
+    return static_cast<std::size_t>(r) * columns + c;
+  }
+
+  double resolution;
+  int columns;
+  int rows;
+
+  private:
+  std::vector<std::uint8_t> cells;
+};
+
+/**
+ * Plans collision-free paths over an OccupancyGrid. A* over the 8-connected
+ * grid finds a route, line-of-sight shortcutting removes the grid's
+ * staircase, and a SplineGenerator smooths the remaining corners into a
+ * profile, which is checked against the grid again.
+ *
+ * The search buffers are kept between calls, so replanning on the same grid
+ * does not allocate them again. That keeps a mid-run replan on the brain to
+ * the search itself.
+ */
+class GridPlanner {
+  public:
+  /**
+   * @param igrid The field map, already inflated by the robot's radius.
+   */
+  explicit GridPlanner(OccupancyGrid igrid) : grid(std::move(igrid)) {}
+
+  /**
+   * Finds a shortest 8-connected route between two points.
+   *
+   * @return The centers of the cells along the route, including the start
+   *         and goal points themselves, or std::nullopt if there is none.
+   */
+  std::optional<std::vector<Pose>>
+  search(double sx, double sy, double gx, double gy) {
+    const int sc = grid.cell(sx), sr = grid.cell(sy);
+    const int gc = grid.cell(gx), gr = grid.cell(gy);
+    if (grid.blocked(sc, sr) || grid.blocked(gc, gr)) {
+      return std::nullopt;
+    }
+
+    const std::size_t n = static_cast<std::size_t>(grid.columns) * grid.rows;
+    cost.assign(n, std::numeric_limits<double>::infinity());
+    parent.assign(n, NONE);
+    closed.assign(n, 0);
+    open.clear();
+
+    const auto heuristic = [&](int c, int r) {
+      // Octile distance, exact on an empty 8-connected grid
+      const double dx = std::abs(c - gc), dy = std::abs(r - gr);
+      return (dx + dy + (M_SQRT2 - 2) * std::min(dx, dy)) * grid.resolution;
+    };
+    const auto later = [](const Node& a, const Node& b) { return a.f > b.f; };
+
+    const std::size_t start = grid.index(sc, sr);
+    const std::size_t goal = grid.index(gc, gr);
+    cost[start] = 0;
+    open.push_back({heuristic(sc, sr), start});
+
+    while (!open.empty()) {
+      std::pop_heap(open.begin(), open.end(), later);
+      const std::size_t current = open.back().index;
+      open.pop_back();
+      if (closed[current]) {
+        continue;
+      }
+      closed[current] = 1;
+      if (current == goal) {
+        break;
+      }
+
+      const int c = static_cast<int>(current % grid.columns);
+      const int r = static_cast<int>(current / grid.columns);
+      for (int dr = -1; dr <= 1; ++dr) {
+        for (int dc = -1; dc <= 1; ++dc) {
+          const int nc = c + dc, nr = r + dr;
+          if ((dc == 0 && dr == 0) || grid.blocked(nc, nr)) {
+            continue;
+          }
+          // Don't cut between two blocked cells diagonally
+          if (dc != 0 && dr != 0 && (grid.blocked(c + dc, r) || grid.blocked(c, r + dr))) {
+            continue;
+          }
+          const std::size_t next = grid.index(nc, nr);
+          const double g =
+            cost[current] + (dc && dr ? M_SQRT2 : 1.0) * grid.resolution;
+          if (g < cost[next]) {
+            cost[next] = g;
+            parent[next] = current;
+            open.push_back({g + heuristic(nc, nr), next});
+            std::push_heap(open.begin(), open.end(), later);
+          }
+        }
+      }
+    }
+
+    if (!closed[goal]) {
+      return std::nullopt;
+    }
+
+    std::vector<Pose> route;
+    route.emplace_back(gx, gy, 0);
+    for (std::size_t i = parent[goal]; i != NONE && i != start; i = parent[i]) {
+      route.emplace_back(grid.center(static_cast<int>(i % grid.columns)),
+                         grid.center(static_cast<int>(i / grid.columns)),
+                         0);
+    }
+    route.emplace_back(sx, sy, 0);
+    std::reverse(route.begin(), route.end());
+    return route;
+  }
+
+  /**
+   * Removes every point of a route that can be skipped with a straight,
+   * collision-free line, going greedily from the start.
+   */
+  std::vector<Pose> shortcut(const std::vector<Pose>& route) const {
+    if (route.size() < 3) {
+      return route;
+    }
+    std::vector<Pose> out{route.front()};
+    std::size_t i = 0;
+    while (i + 1 < route.size()) {
+      std::size_t j = route.size() - 1;
+      while (j > i + 1 &&
+             !grid.line_free(route[i].x, route[i].y, route[j].x, route[j].y)) {
+        --j;
+      }
+      out.push_back(route[j]);
+      i = j;
+    }
+    return out;
+  }
+
+  /**
+   * Plans a profile from one pose to another.
+   *
+   * The shortcut route's corners become waypoints, each facing halfway
+   * between the legs on either side of it. If the spline through them cuts
+   * through an obstacle, the leg nearest the first collision is split at its
+   * midpoint and the spline is generated again.
+   *
+   * @return The profile, or std::nullopt if there is no route, the generator
+   *         returns an empty profile or no collision-free spline was found.
+   */
+  std::optional<std::vector<ProfilePoint>>
+  plan(const Pose& start, const Pose& goal, SplineGenerator& generator) {
+    const auto route = search(start.x, start.y, goal.x, goal.y);
+    if (!route) {
+      return std::nullopt;
+    }
+    std::vector<Pose> waypoints = shortcut(*route);
+    waypoints.front() = start;
+    waypoints.back() = goal;
+
+    for (int attempt = 0; attempt < MAX_REFINEMENTS; ++attempt) {
+      set_headings(waypoints);
+      auto profile = generator.generate(waypoints);
+      if (profile.empty()) {
+        return std::nullopt;
+      }
+      const std::size_t hit = first_collision(profile);
+      if (hit == profile.size()) {
+        return profile;
+      }
+
+      // Split the leg closest to the collision
+      const Pose& p = profile[hit].vector.pose;
+      std::size_t nearest = 0;
+      double best = std::numeric_limits<double>::infinity();
+      for (std::size_t i = 0; i + 1 < waypoints.size(); ++i) {
+        const double d = distance_to_leg(p, waypoints[i], waypoints[i + 1]);
+        if (d < best) {
+          best = d;
+          nearest = i;
+        }
+      }
+      const Pose& a = waypoints[nearest];
+      const Pose& b = waypoints[nearest + 1];
+      waypoints.insert(waypoints.begin() + nearest + 1,
+                       Pose((a.x + b.x) / 2, (a.y + b.y) / 2, 0));
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * The index of the first profile point inside an obstacle, or the size of
+   * the profile if there is none.
+   */
+  std::size_t first_collision(const std::vector<ProfilePoint>& profile) const {
+    for (std::size_t i = 0; i < profile.size(); ++i) {
+      if (grid.blocked(profile[i].vector.pose.x, profile[i].vector.pose.y)) {
+        return i;
+      }
+    }
+    return profile.size();
+  }
+
+  const OccupancyGrid& map() const {
+    return grid;
+  }
+
+  static constexpr int MAX_REFINEMENTS = 8;
+
+  protected:
+  static constexpr std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+  struct Node {
+    double f;
+    std::size_t index;
+  };
+
+  static void set_headings(std::vector<Pose>& waypoints) {
+    for (std::size_t i = 1; i + 1 < waypoints.size(); ++i) {
+      const double in = std::atan2(waypoints[i].y - waypoints[i - 1].y,
+                                   waypoints[i].x - waypoints[i - 1].x);
+      const double out = std::atan2(waypoints[i + 1].y - waypoints[i].y,
+                                    waypoints[i + 1].x - waypoints[i].x);
+      waypoints[i].yaw = in + std::remainder(out - in, 2 * M_PI) / 2;
+    }
+  }
+
+  static double distance_to_leg(const Pose& p, const Pose& a, const Pose& b) {
+    const double dx = b.x - a.x, dy = b.y - a.y;
+    const double length2 = dx * dx + dy * dy;
+    const double f =
+      length2 > 0 ? std::clamp(((p.x - a.x) * dx + (p.y - a.y) * dy) / length2, 0.0, 1.0)
+                  : 0.0;
+    return std::hypot(p.x - (a.x + dx * f), p.y - (a.y + dy * f));
+  }
+
+  OccupancyGrid grid;
+  std::vector<double> cost;
+  std::vector<std::size_t> parent;
+  std::vector<std::uint8_t> closed;
+  std::vector<Node> open;
+};
+} // namespace squiggles
+
+#endif
@@ -0,0 +1,124 @@
+/**
+ * Copyright 2020 Jonathan Bayless
+ *
+ * Use of this source code is governed by an MIT-style license that can be found
+ * in the LICENSE file or at https://opensource.org/licenses/MIT.
+ */
+#ifndef _SQUIGGLES_INCREMENTAL_SPLINE_HPP_
+#define _SQUIGGLES_INCREMENTAL_SPLINE_HPP_
+
+#include <memory>
+#include <vector>
+
+#include "parallelspline.hpp"
+
+namespace squiggles {
+/**
+ * A SplineGenerator that remembers the raw spline of every segment it has
+ * generated, keyed by the segment's end points. Regenerating a path after
+ * moving one waypoint only searches the (at most two) segments touching that
+ * waypoint again. Every other segment is taken from the cache.
+ *
+ * The joined path is always parameterized from the start. The velocity
+ * profile comes from a forward and a backward pass over the whole path, so a
+ * change near the end can lower the velocity anywhere before it, and a
+ * partial pass would not match a full one. Parameterizing is cheap next to
+ * the spline search, which is what the cache skips.
+ *
+ * The result is bit-identical to SplineGenerator::generate with the same
+ * waypoints.
+ */
+class IncrementalSplineGenerator : public ParallelSplineGenerator {
+  public:
+  using ParallelSplineGenerator::ParallelSplineGenerator;
+
+  std::vector<ProfilePoint> generate_incremental(std::vector<Pose> iwaypoints,
+                                                 bool fast = false) {
+    return generate_incremental(to_vectors(iwaypoints), fast);
+  }
+
+  /**
+   * Generates a path through the waypoints, reusing every segment whose end
+   * points are unchanged since the previous call.
+   */
+  std::vector<ProfilePoint>
+  generate_incremental(std::vector<ControlVector> iwaypoints,
+                       bool fast = false) {
+    regenerated = 0;
+    if (iwaypoints.size() < 2) {
+      return {};
+    }
+
+    std::vector<CachedSegment> next;
+    next.reserve(iwaypoints.size() - 1);
+    std::vector<GeneratedPoint> raw_path;
+    ControlVector first;
+    ControlVector current = iwaypoints[0];
+
+    for (std::size_t i = 0; i + 1 < iwaypoints.size(); ++i) {
+      const ControlVector& end = iwaypoints[i + 1];
+      const CachedSegment* hit = find(current, end, fast);
+      if (hit != nullptr) {
+        next.push_back(*hit);
+      } else {
+        // gen_raw_path may update its end points, so keep both what went in
+        // (the cache key) and what came out
+        CachedSegment segment{current, end, fast, current, end, {}};
+        segment.raw = gen_raw_path(segment.start_out, segment.end_out, fast);
+        next.push_back(std::move(segment));
+        ++regenerated;
+      }
+
+      const CachedSegment& segment = next.back();
+      if (i == 0) {
+        first = segment.start_out;
+      }
+      raw_path.insert(raw_path.end(), segment.raw.begin(), segment.raw.end());
+      current = segment.end_out;
+    }
+
+    // Only keep the segments of the latest path, so the cache never grows
+    // past the number of segments being edited
+    cache = std::move(next);
+    return finish(first, current, raw_path);
+  }
+
+  /**
+   * @return The number of segments that were searched (rather than reused) by
+   *         the last call to generate_incremental.
+   */
+  std::size_t last_regenerated() const {
+    return regenerated;
+  }
+
+  void clear_cache() {
+    cache.clear();
+  }
+
+  protected:
+  struct CachedSegment {
+    ControlVector start;
+    ControlVector end;
+    bool fast;
+    ControlVector start_out;
+    ControlVector end_out;
+    std::vector<GeneratedPoint> raw;
+  };
+
+  const CachedSegment*
+  find(const ControlVector& start, const ControlVector& end, bool fast) const {
+    for (const auto& segment : cache) {
+      if (segment.fast == fast && same_bits(segment.start, start) &&
+          same_bits(segment.end, end)) {
+        return &segment;
+      }
+    }
+    return nullptr;
+  }
+
+  std::vector<CachedSegment> cache;
+  std::size_t regenerated = 0;
+};
+} // namespace squiggles
+
+#endif
@@ -0,0 +1,429 @@
+/**
+ * Copyright 2020 Jonathan Bayless
+ *
+ * Use of this source code is governed by an MIT-style license that can be found
+ * in the LICENSE file or at https://opensource.org/licenses/MIT.
+ */
+#ifndef _SQUIGGLES_JERK_LIMITED_SPLINE_HPP_
+#define _SQUIGGLES_JERK_LIMITED_SPLINE_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "spline.hpp"
+
+namespace squiggles {
+/**
+ * A SplineGenerator whose velocity profile also honors Constraints::max_jerk.
+ *
+ * The raw path comes from gen_raw_path as usual. A trapezoidal profile is
+ * built over it with the velocity and acceleration limits of the constraints
+ * and the PhysicalModel (so TankModel wheel limits keep applying). That
+ * profile is then passed through a moving average in time, just long enough
+ * that the acceleration never changes faster than max_jerk. Averaging makes
+ * the path longer by exactly the averaging window, which is the shortest ramp
+ * from zero to full acceleration at the jerk limit.
+ *
+ * Where the limits are the same everywhere, averaging keeps the profile
+ * within them. Where they aren't, as with TankModel, whose limits shrink with
+ * curvature, averaging can carry speed or acceleration from a straight into
+ * the start of a curve. Any point that ends up over its speed or acceleration
+ * limit lowers that limit over the part of the trapezoid it was averaged
+ * from, and the profile is rebuilt until every point is within its limits. If
+ * some point is still over a limit after MAX_JERK_ITERATIONS rebuilds,
+ * generation fails and returns an empty path.
+ */
+class JerkLimitedSplineGenerator : public SplineGenerator {
+  public:
+  using SplineGenerator::SplineGenerator;
+
+  std::vector<ProfilePoint> generate_jerk_limited(std::vector<Pose> iwaypoints,
+                                                  bool fast = false) {
+    std::vector<ControlVector> vectors;
+    vectors.reserve(iwaypoints.size());
+    for (const auto& p : iwaypoints) {
+      vectors.emplace_back(p);
+    }
+    return generate_jerk_limited(vectors, fast);
+  }
+
+  std::vector<ProfilePoint>
+  generate_jerk_limited(std::vector<ControlVector> iwaypoints,
+                        bool fast = false) {
+    if (iwaypoints.size() < 2) {
+      return {};
+    }
+    std::vector<GeneratedPoint> raw_path;
+    for (std::size_t i = 0; i + 1 < iwaypoints.size(); ++i) {
+      auto segment = gen_raw_path(iwaypoints[i], iwaypoints[i + 1], fast);
+      raw_path.insert(raw_path.end(), segment.begin(), segment.end());
+    }
+    const auto& start = iwaypoints.front();
+    const auto& end = iwaypoints.back();
+    return parameterize_jerk_limited(raw_path,
+                                     std::isnan(start.vel) ? 0.0 : start.vel,
+                                     std::isnan(end.vel) ? 0.0 : end.vel,
+                                     0.0);
+  }
+
+  /**
+   * Imposes a jerk-limited motion profile on the raw path.
+   *
+   * The smoothing window extends the start and end of the path at the start
+   * and end velocities, so paths that start and end at rest are followed
+   * exactly. With a moving start or end the robot reaches the end of the path
+   * at a slightly different time than the profile says.
+   *
+   * @param raw_path The points of the curve, in order
+   * @param start_vel The velocity at the start of the path in meters per
+   *                  second
+   * @param end_vel The velocity at the end of the path in meters per second
+   * @param start_time The timestamp of the first point in seconds
+   * @return The profile, or an empty path if it can't be brought within its
+   *         speed and acceleration limits in MAX_JERK_ITERATIONS rebuilds
+   */
+  std::vector<ProfilePoint>
+  parameterize_jerk_limited(const std::vector<GeneratedPoint>& raw_path,
+                            double start_vel,
+                            double end_vel,
+                            double start_time) {
+    Track track;
+    for (const auto& p : raw_path) {
+      const double ds =
+        track.points.empty() ? 0.0
+                             : std::hypot(p.pose.x - track.points.back().pose.x,
+                                          p.pose.y - track.points.back().pose.y);
+      // Segments share their end points, so drop repeated samples
+      if (!track.points.empty() && ds < K_EPSILON) {
+        continue;
+      }
+      track.dist.push_back(track.points.empty() ? 0.0 : track.dist.back() + ds);
+      track.points.push_back(p);
+    }
+    const std::size_t n = track.points.size();
+    if (n < 2) {
+      return {};
+    }
+
+    track.limit.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      track.limit[i] =
+        std::min(constraints.max_vel,
+                 model
+                   ->constraints(track.points[i].pose,
+                                 track.points[i].curvature,
+                                 constraints.max_vel)
+                   .max_vel);
+    }
+    const std::vector<double> speed_limit = track.limit;
+    track.limit[0] = std::min(track.limit[0], start_vel);
+    track.limit[n - 1] = std::min(track.limit[n - 1], end_vel);
+    track.max_accel.assign(n, constraints.max_accel);
+    track.max_decel.assign(n, -constraints.min_accel);
+
+    Series smooth;
+    bool over = true;
+    for (int iteration = 0; over && iteration < MAX_JERK_ITERATIONS;
+         ++iteration) {
+      const Series trapezoid = sample_trapezoid(track, trapezoid_velocities(track));
+      smooth = limit_jerk(trapezoid, start_vel, end_vel);
+
+      // Anything over its speed or acceleration limits lowers that limit on
+      // the trapezoid everywhere it was averaged from. The velocity at k
+      // averages trapezoid samples k - window + 1 to k, and the acceleration
+      // from k to k + 1 averages the trapezoid's from k - window + 1 to k + 1.
+      over = false;
+      const std::size_t last_sample = trapezoid.dist.size() - 1;
+      std::size_t j = 0;
+      for (std::size_t k = 0; k < smooth.vel.size(); ++k) {
+        j = locate(track, smooth.dist[k], j);
+        const double f = fraction(track, j, smooth.dist[k]);
+        const std::size_t first = std::min(
+          last_sample, k + 1 > smooth.window ? k + 1 - smooth.window : 0);
+
+        const double limit =
+          speed_limit[j] + (speed_limit[j + 1] - speed_limit[j]) * f;
+        if (smooth.vel[k] > limit * (1 + K_JERK_TOLERANCE)) {
+          over = true;
+          lower(track,
+                track.limit,
+                trapezoid,
+                first,
+                std::min(k, last_sample),
+                limit);
+        }
+
+        if (k + 1 == smooth.vel.size()) {
+          break;
+        }
+        const double accel = (smooth.vel[k + 1] - smooth.vel[k]) / dt;
+        const GeneratedPoint point = point_at(track, j, f);
+        const Constraints model_limits =
+          model->constraints(point.pose, point.curvature, smooth.vel[k]);
+        const double max_accel =
+          std::min(constraints.max_accel, model_limits.max_accel);
+        const double max_decel =
+          std::min(-constraints.min_accel, -model_limits.min_accel);
+        const std::size_t last = std::min(k + 1, last_sample);
+        if (accel > max_accel * (1 + K_JERK_TOLERANCE)) {
+          over = true;
+          lower(track, track.max_accel, trapezoid, first, last, max_accel);
+        } else if (-accel > max_decel * (1 + K_JERK_TOLERANCE)) {
+          over = true;
+          lower(track, track.max_decel, trapezoid, first, last, max_decel);
+        }
+      }
+    }
+    if (over) {
+      return {};
+    }
+
+    return to_profile(track, smooth, start_time);
+  }
+
+  /**
+   * The most times the profile is rebuilt to bring curves back under their
+   * speed and acceleration limits before generation gives up.
+   */
+  static constexpr int MAX_JERK_ITERATIONS = 50;
+
+  protected:
+  static constexpr double K_JERK_TOLERANCE = 1e-6;
+
+  /**
+   * The raw path, the distance along it, and the speed limit and any lowered
+   * acceleration limits at each point. The acceleration limits only hold what
+   * the rebuilds have lowered, and are applied on top of the constraints and
+   * the model's.
+   */
+  struct Track {
+    std::vector<GeneratedPoint> points;
+    std::vector<double> dist;
+    std::vector<double> limit;
+    std::vector<double> max_accel;
+    std::vector<double> max_decel;
+  };
+
+  /**
+   * A profile sampled every dt seconds.
+   */
+  struct Series {
+    std::vector<double> dist;
+    std::vector<double> vel;
+    std::size_t window = 1;
+  };
+
+  /**
+   * The velocity at each point given only velocity and acceleration limits,
+   * from the usual forward and backward passes.
+   */
+  std::vector<double> trapezoid_velocities(const Track& track) {
+    const std::size_t n = track.points.size();
+    std::vector<double> vel(track.limit);
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+      const double a = std::min({constraints.max_accel,
+                                 track.max_accel[i],
+                                 model
+                                   ->constraints(track.points[i].pose,
+                                                 track.points[i].curvature,
+                                                 vel[i])
+                                   .max_accel});
+      const double ds = track.dist[i + 1] - track.dist[i];
+      vel[i + 1] = std::min(vel[i + 1], std::sqrt(vel[i] * vel[i] + 2 * a * ds));
+    }
+    for (std::size_t i = n - 1; i > 0; --i) {
+      const double d = std::min({-constraints.min_accel,
+                                 track.max_decel[i],
+                                 -model
+                                    ->constraints(track.points[i].pose,
+                                                  track.points[i].curvature,
+                                                  vel[i])
+                                    .min_accel});
+      const double ds = track.dist[i] - track.dist[i - 1];
+      vel[i - 1] = std::min(vel[i - 1], std::sqrt(vel[i] * vel[i] + 2 * d * ds));
+    }
+    return vel;
+  }
+
+  /**
+   * Samples a velocity profile every dt seconds. The acceleration between two
+   * points is constant, so both distance and velocity are exact.
+   */
+  Series sample_trapezoid(const Track& track, const std::vector<double>& vel) {
+    const std::size_t n = track.points.size();
+    std::vector<double> times(n, 0.0);
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+      const double v = vel[i] + vel[i + 1];
+      times[i + 1] =
+        times[i] + 2 * (track.dist[i + 1] - track.dist[i]) / std::max(v, K_EPSILON);
+    }
+
+    Series out;
+    std::size_t i = 0;
+    for (std::size_t k = 0;; ++k) {
+      const double t = std::min(k * dt, times.back());
+      while (i + 2 < n && times[i + 1] <= t) {
+        ++i;
+      }
+      const double ds = track.dist[i + 1] - track.dist[i];
+      const double a = (vel[i + 1] * vel[i + 1] - vel[i] * vel[i]) / (2 * ds);
+      const double tau = t - times[i];
+      out.vel.push_back(std::max(0.0, vel[i] + a * tau));
+      out.dist.push_back(std::min(track.dist[i + 1],
+                                  track.dist[i] + vel[i] * tau + a * tau * tau / 2));
+      if (t >= times.back()) {
+        break;
+      }
+    }
+    return out;
+  }
+
+  /**
+   * Smooths the velocity with the shortest moving average that keeps the
+   * jerk within max_jerk.
+   */
+  Series limit_jerk(const Series& in, double start_vel, double end_vel) {
+    const double max_jerk = constraints.max_jerk;
+    const double max_step = std::max(
+      constraints.max_accel == std::numeric_limits<double>::max()
+        ? 0.0
+        : constraints.max_accel,
+      constraints.min_accel == std::numeric_limits<double>::lowest()
+        ? 0.0
+        : -constraints.min_accel);
+    std::size_t window =
+      max_jerk == std::numeric_limits<double>::max() || max_step == 0
+        ? 1
+        : static_cast<std::size_t>(
+            std::max(1.0, std::ceil(max_step / (max_jerk * dt) - K_JERK_TOLERANCE)));
+
+    Series out;
+    for (;; ++window) {
+      out = moving_average(in, window, start_vel, end_vel);
+      if (window >= in.vel.size() || max_jerk_of(out) <= max_jerk * (1 + K_JERK_TOLERANCE)) {
+        return out;
+      }
+    }
+  }
+
+  Series moving_average(const Series& in,
+                        std::size_t window,
+                        double start_vel,
+                        double end_vel) const {
+    const std::size_t n = in.vel.size();
+    Series out;
+    out.window = window;
+    out.vel.reserve(n + window - 1);
+    out.dist.reserve(n + window - 1);
+
+    double sum = start_vel * (window - 1);
+    const double total = in.dist.back();
+    for (std::size_t k = 0; k < n + window - 1; ++k) {
+      // The window holds samples k - window + 1 to k, and anything before the
+      // start or past the end of the path moves at the start or end velocity
+      sum += k < n ? in.vel[k] : end_vel;
+      if (k >= window) {
+        sum -= k - window < n ? in.vel[k - window] : end_vel;
+      } else if (k > 0) {
+        sum -= start_vel;
+      }
+      const double v = sum / window;
+      const double d =
+        out.vel.empty() ? 0.0 : out.dist.back() + (out.vel.back() + v) / 2 * dt;
+      out.vel.push_back(v);
+      out.dist.push_back(std::min(d, total));
+    }
+    out.vel.back() = end_vel;
+    out.dist.back() = total;
+    return out;
+  }
+
+  double max_jerk_of(const Series& s) const {
+    double out = 0;
+    for (std::size_t k = 2; k < s.vel.size(); ++k) {
+      out = std::max(out,
+                     std::fabs(s.vel[k] - 2 * s.vel[k - 1] + s.vel[k - 2]) /
+                       (dt * dt));
+    }
+    return out;
+  }
+
+  /**
+   * The index of the raw path step containing a distance, searching forward
+   * from a hint.
+   */
+  static std::size_t locate(const Track& track, double dist, std::size_t hint) {
+    while (hint + 2 < track.dist.size() && track.dist[hint + 1] < dist) {
+      ++hint;
+    }
+    return hint;
+  }
+
+  static double fraction(const Track& track, std::size_t i, double dist) {
+    return std::clamp((dist - track.dist[i]) / (track.dist[i + 1] - track.dist[i]),
+                      0.0,
+                      1.0);
+  }
+
+  /**
+   * The pose and curvature a fraction of the way along a raw path step.
+   */
+  static GeneratedPoint point_at(const Track& track, std::size_t i, double f) {
+    const Pose& p0 = track.points[i].pose;
+    const Pose& p1 = track.points[i + 1].pose;
+    return GeneratedPoint(
+      Pose(p0.x + (p1.x - p0.x) * f,
+           p0.y + (p1.y - p0.y) * f,
+           p0.yaw + std::remainder(p1.yaw - p0.yaw, 2 * M_PI) * f),
+      track.points[i].curvature +
+        (track.points[i + 1].curvature - track.points[i].curvature) * f);
+  }
+
+  /**
+   * Lowers a per-point limit to at most value on every raw path point that
+   * the trapezoid samples first to last pass through.
+   */
+  static void lower(Track& track,
+                    std::vector<double>& limits,
+                    const Series& trapezoid,
+                    std::size_t first,
+                    std::size_t last,
+                    double value) {
+    const std::size_t n = track.points.size();
+    for (std::size_t i = 0; i < n; ++i) {
+      const double before = i > 0 ? track.dist[i - 1] : track.dist[i];
+      const double after = i + 1 < n ? track.dist[i + 1] : track.dist[i];
+      if (after >= trapezoid.dist[first] && before <= trapezoid.dist[last]) {
+        limits[i] = std::min(limits[i], value);
+      }
+    }
+  }
+
+  std::vector<ProfilePoint>
+  to_profile(const Track& track, const Series& s, double start_time) {
+    std::vector<ProfilePoint> out;
+    out.reserve(s.vel.size());
+    std::size_t i = 0;
+    for (std::size_t k = 0; k < s.vel.size(); ++k) {
+      i = locate(track, s.dist[k], i);
+      const GeneratedPoint point = point_at(track, i, fraction(track, i, s.dist[k]));
+
+      const double accel =
+        k + 1 < s.vel.size() ? (s.vel[k + 1] - s.vel[k]) / dt : 0.0;
+      const double prev_accel = k > 0 ? (s.vel[k] - s.vel[k - 1]) / dt : 0.0;
+      const double jerk = (accel - prev_accel) / dt;
+
+      out.emplace_back(ControlVector(point.pose, s.vel[k], accel, jerk),
+                       model->linear_to_wheel_vels(s.vel[k], point.curvature),
+                       point.curvature,
+                       start_time + k * dt);
+    }
+    return out;
+  }
+};
+} // namespace squiggles
+
+#endif
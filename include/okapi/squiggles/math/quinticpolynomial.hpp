@@ -7,6 +7,7 @@
 #ifndef _MATH_QUINTIC_POLYNOMIAL_HPP_
 #define _MATH_QUINTIC_POLYNOMIAL_HPP_
 
+#include <cstddef>
 #include <string>
 
 namespace squiggles {
@@ -42,6 +43,70 @@ class QuinticPolynomial {
   double calc_second_derivative(double t);
   double calc_third_derivative(double t);
 
+  /**
+   * The polynomial and its first three derivatives at one time stamp.
+   */
+  struct Sample {
+    double p;
+    double v;
+    double a;
+    double j;
+  };
+
+  /**
+   * Calculates the polynomial and all three derivatives at each of n time
+   * stamps in one pass, sharing the powers of t between them. The derivative
+   * coefficients are computed once and evaluated in the same order as
+   * calc_batch_xy, so both give the same results.
+   */
+  void calc_batch(const double* t, std::size_t n, Sample* out) const {
+    const double d2 = 2 * a2, d3 = 3 * a3, d4 = 4 * a4, d5 = 5 * a5;
+    const double e2 = 2 * a2, e3 = 6 * a3, e4 = 12 * a4, e5 = 20 * a5;
+    const double f3 = 6 * a3, f4 = 24 * a4, f5 = 60 * a5;
+    for (std::size_t i = 0; i < n; ++i) {
+      const double s = t[i];
+      out[i] = {a0 + s * (a1 + s * (a2 + s * (a3 + s * (a4 + s * a5)))),
+                a1 + s * (d2 + s * (d3 + s * (d4 + s * d5))),
+                e2 + s * (e3 + s * (e4 + s * e5)),
+                f3 + s * (f4 + s * f5)};
+    }
+  }
+
+  /**
+   * Calculates an x and a y polynomial and their derivatives together at each
+   * of n time stamps. With GCC the two axes are evaluated as the two lanes of
+   * one vector, which maps to SSE2 on x86. Targets without double precision
+   * vector instructions, such as the V5's Cortex-A9, get the same code split
+   * into scalar operations.
+   */
+  static void calc_batch_xy(const QuinticPolynomial& x,
+                            const QuinticPolynomial& y,
+                            const double* t,
+                            std::size_t n,
+                            Sample* out_x,
+                            Sample* out_y) {
+#if defined(__GNUC__) && !defined(SQUIGGLES_NO_VECTOR)
+    typedef double lanes __attribute__((vector_size(2 * sizeof(double))));
+    const lanes c0 = {x.a0, y.a0}, c1 = {x.a1, y.a1}, c2 = {x.a2, y.a2},
+                c3 = {x.a3, y.a3}, c4 = {x.a4, y.a4}, c5 = {x.a5, y.a5};
+    const lanes d1 = c1, d2 = 2 * c2, d3 = 3 * c3, d4 = 4 * c4, d5 = 5 * c5;
+    const lanes e2 = 2 * c2, e3 = 6 * c3, e4 = 12 * c4, e5 = 20 * c5;
+    const lanes f3 = 6 * c3, f4 = 24 * c4, f5 = 60 * c5;
+    for (std::size_t i = 0; i < n; ++i) {
+      const lanes s = {t[i], t[i]};
+      const lanes p = c0 + s * (c1 + s * (c2 + s * (c3 + s * (c4 + s * c5))));
+      const lanes v = d1 + s * (d2 + s * (d3 + s * (d4 + s * d5)));
+      const lanes a = e2 + s * (e3 + s * (e4 + s * e5));
+      const lanes j = f3 + s * (f4 + s * f5);
+      out_x[i] = {p[0], v[0], a[0], j[0]};
+      out_y[i] = {p[1], v[1], a[1], j[1]};
+    }
+#else
+    x.calc_batch(t, n, out_x);
+    y.calc_batch(t, n, out_y);
+#endif
+  }
+
   /**
    * Serializes the Quintic Polynomial data for debugging.
    *
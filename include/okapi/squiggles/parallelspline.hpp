@@ -0,0 +1,172 @@
+/**
+ * Copyright 2020 Jonathan Bayless
+ *
+ * Use of this source code is governed by an MIT-style license that can be found
+ * in the LICENSE file or at https://opensource.org/licenses/MIT.
+ */
+#ifndef _SQUIGGLES_PARALLEL_SPLINE_HPP_
+#define _SQUIGGLES_PARALLEL_SPLINE_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+#ifdef THREADS_STD
+#include <thread>
+#endif
+
+#include "spline.hpp"
+
+namespace squiggles {
+/**
+ * A SplineGenerator that searches for the spline of every segment of a
+ * multi-waypoint path concurrently, then parameterizes the joined path once.
+ *
+ * The per-segment search (gen_raw_path, which runs the duration search or
+ * gradient descent) is independent for each pair of waypoints, so the
+ * segments are handed out to a pool of worker threads. The resulting raw
+ * segments are joined in waypoint order and passed through one parameterize
+ * step with the same arguments SplineGenerator::generate uses, so both give
+ * bit-identical paths.
+ *
+ * generate passes each waypoint by reference to the segments on both sides
+ * of it, and in fast mode the search writes the velocity it settled on into a
+ * free (NaN) end velocity. The segment after such a waypoint can only be
+ * searched once the one before it is done, so with fast set and free interior
+ * velocities the segments run one after another, no faster than generate.
+ *
+ * Worker threads are only used in host builds with THREADS_STD. On the
+ * brain generate_parallel runs the segments one after another.
+ */
+class ParallelSplineGenerator : public SplineGenerator {
+  public:
+  /**
+   * @param ithreads The number of worker threads, or 0 to use one per
+   *                 hardware thread.
+   */
+  ParallelSplineGenerator(Constraints iconstraints,
+                          std::shared_ptr<PhysicalModel> imodel =
+                            std::make_shared<PassthroughModel>(),
+                          double idt = 0.1,
+                          std::size_t ithreads = 0)
+    : SplineGenerator(iconstraints, imodel, idt), threads(ithreads) {}
+
+  std::vector<ProfilePoint> generate_parallel(std::vector<Pose> iwaypoints,
+                                              bool fast = false) {
+    return generate_parallel(to_vectors(iwaypoints), fast);
+  }
+
+  /**
+   * Generates a path through the waypoints with the segments searched
+   * concurrently.
+   */
+  std::vector<ProfilePoint>
+  generate_parallel(std::vector<ControlVector> iwaypoints, bool fast = false) {
+    if (iwaypoints.size() < 2) {
+      return {};
+    }
+    const std::size_t segments = iwaypoints.size() - 1;
+
+    // Every worker gets its own copies of the segment's end points. A segment
+    // whose start will be rewritten by the one before it is left for the
+    // joining loop below.
+    std::vector<Segment> work(segments);
+    std::vector<std::size_t> independent;
+    for (std::size_t i = 0; i < segments; ++i) {
+      work[i].start = iwaypoints[i];
+      work[i].end = iwaypoints[i + 1];
+      if (i == 0 || !fast || !std::isnan(iwaypoints[i].vel)) {
+        independent.push_back(i);
+      }
+    }
+
+    std::atomic<std::size_t> next{0};
+    auto worker = [&]() {
+      for (std::size_t k = next++; k < independent.size(); k = next++) {
+        Segment& segment = work[independent[k]];
+        segment.raw = gen_raw_path(segment.start, segment.end, fast);
+        segment.searched = true;
+      }
+    };
+
+#ifdef THREADS_STD
+    std::size_t count = threads ? threads : std::thread::hardware_concurrency();
+    count = std::max<std::size_t>(1, std::min(count, independent.size()));
+    std::vector<std::thread> pool;
+    for (std::size_t i = 1; i < count; ++i) {
+      pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : pool) {
+      t.join();
+    }
+#else
+    worker();
+#endif
+
+    // generate passes each waypoint by reference to the segments on both
+    // sides of it. If a segment updated its end point, the next segment would
+    // have started from the updated value, so any segment whose start no
+    // longer matches is searched (again) from the updated point.
+    std::vector<GeneratedPoint> raw_path;
+    ControlVector current = iwaypoints[0];
+    for (std::size_t i = 0; i < segments; ++i) {
+      if (!work[i].searched || !same_bits(current, iwaypoints[i])) {
+        work[i].start = current;
+        work[i].end = iwaypoints[i + 1];
+        work[i].raw = gen_raw_path(work[i].start, work[i].end, fast);
+      }
+      raw_path.insert(raw_path.end(), work[i].raw.begin(), work[i].raw.end());
+      current = work[i].end;
+    }
+
+    return finish(work[0].start, current, raw_path);
+  }
+
+  std::size_t threads;
+
+  protected:
+  struct Segment {
+    ControlVector start;
+    ControlVector end;
+    std::vector<GeneratedPoint> raw;
+    bool searched = false;
+  };
+
+  static std::vector<ControlVector> to_vectors(const std::vector<Pose>& poses) {
+    std::vector<ControlVector> vectors;
+    vectors.reserve(poses.size());
+    for (const auto& p : poses) {
+      vectors.emplace_back(p);
+    }
+    return vectors;
+  }
+
+  /**
+   * Compares two vectors exactly, treating identical NaNs as equal.
+   */
+  static bool same_bits(const ControlVector& a, const ControlVector& b) {
+    const double lhs[] = {
+      a.pose.x, a.pose.y, a.pose.yaw, a.vel, a.accel, a.jerk};
+    const double rhs[] = {
+      b.pose.x, b.pose.y, b.pose.yaw, b.vel, b.accel, b.jerk};
+    return std::memcmp(lhs, rhs, sizeof(lhs)) == 0;
+  }
+
+  /**
+   * Parameterizes a joined path the way SplineGenerator::generate does, from
+   * the first and last waypoints as the search left them.
+   */
+  std::vector<ProfilePoint> finish(const ControlVector& start,
+                                   const ControlVector& end,
+                                   const std::vector<GeneratedPoint>& raw_path) {
+    const double start_vel = std::isnan(start.vel) ? 0.0 : start.vel;
+    const double end_vel = std::isnan(end.vel) ? 0.0 : end.vel;
+    return parameterize(start, end, raw_path, start_vel, end_vel, 0.0);
+  }
+};
+} // namespace squiggles
+
+#endif
@@ -0,0 +1,282 @@
+/**
+ * Copyright 2020 Jonathan Bayless
+ *
+ * Use of this source code is governed by an MIT-style license that can be found
+ * in the LICENSE file or at https://opensource.org/licenses/MIT.
+ */
+#ifndef _SQUIGGLES_PATH_CACHE_HPP_
+#define _SQUIGGLES_PATH_CACHE_HPP_
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "binaryio.hpp"
+#include "constraints.hpp"
+#include "geometry/pose.hpp"
+#include "geometry/profilepoint.hpp"
+
+namespace squiggles {
+/**
+ * A 64 bit FNV-1a hash of everything a generated path depends on. Two keys
+ * are equal only if every value added to them was bit-for-bit identical, in
+ * the same order.
+ */
+class PathKey {
+  public:
+  PathKey& add(const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+      hash = (hash ^ bytes[i]) * PRIME;
+    }
+    return *this;
+  }
+
+  PathKey& add(double value) {
+    // Make 0.0 and -0.0 the same key
+    if (value == 0) {
+      value = 0;
+    }
+    return add(&value, sizeof(value));
+  }
+
+  PathKey& add(const Pose& pose) {
+    return add(pose.x).add(pose.y).add(pose.yaw);
+  }
+
+  PathKey& add(const Constraints& constraints) {
+    return add(constraints.max_vel)
+      .add(constraints.max_accel)
+      .add(constraints.max_jerk)
+      .add(constraints.max_curvature)
+      .add(constraints.min_accel);
+  }
+
+  PathKey& add(const std::string& value) {
+    const std::uint64_t size = value.size();
+    return add(&size, sizeof(size)).add(value.data(), value.size());
+  }
+
+  /**
+   * The key as 16 hex digits, used as the cached path's file name.
+   */
+  std::string to_string() const {
+    char out[17];
+    std::snprintf(out, sizeof(out), "%016llx", static_cast<unsigned long long>(hash));
+    return out;
+  }
+
+  bool operator==(const PathKey& other) const {
+    return hash == other.hash;
+  }
+
+  std::uint64_t hash = OFFSET_BASIS;
+
+  private:
+  static constexpr std::uint64_t OFFSET_BASIS = 0xcbf29ce484222325ull;
+  static constexpr std::uint64_t PRIME = 0x100000001b3ull;
+};
+
+/**
+ * A cache of generated paths keyed by their PathKey, so the same waypoints
+ * and limits are never generated twice.
+ *
+ * Recently used paths are kept in memory up to a byte budget, evicting the
+ * least recently used first. If a directory is given, every path is also
+ * written there in the binary format of binaryio.hpp, which keeps it across
+ * reboots.
+ *
+ * The binary format rounds every value to 16 bits. So that a key always
+ * gives the same points, whichever tier it hits and whether or not the brain
+ * has rebooted, a path written to the directory is read back and the rounded
+ * copy is what the cache keeps and returns, starting with the call that
+ * generated it. Without a directory, or if writing the file fails, paths are
+ * kept exactly as generated.
+ *
+ * The cache is not thread safe.
+ */
+class PathCache {
+  public:
+  /**
+   * @param imax_bytes The most memory the in-memory paths may use.
+   * @param idirectory The directory to keep path files in, for example
+   *                   "/usd/paths". It must already exist. If it is empty,
+   *                   paths are only cached in memory.
+   */
+  explicit PathCache(std::size_t imax_bytes = 256 * 1024,
+                     std::string idirectory = "")
+    : max_bytes(imax_bytes), directory(std::move(idirectory)) {}
+
+  /**
+   * Returns the path for the key, from memory, then from the directory, then
+   * by calling generate and caching what it returns. A generated path is
+   * returned as insert() stores it. An empty path from generate is returned
+   * but not cached.
+   */
+  template <class F>
+  std::vector<ProfilePoint> get_or_generate(const PathKey& key, F&& generate) {
+    if (auto path = find(key)) {
+      return std::move(*path);
+    }
+    ++misses;
+    std::vector<ProfilePoint> path = generate();
+    if (path.empty()) {
+      return path;
+    }
+    return insert(key, path);
+  }
+
+  /**
+   * Looks a path up in memory and then in the directory. A path found in the
+   * directory is also brought into memory.
+   */
+  std::optional<std::vector<ProfilePoint>> find(const PathKey& key) {
+    const auto entry = index.find(key.hash);
+    if (entry != index.end()) {
+      ++memory_hits;
+      entries.splice(entries.begin(), entries, entry->second);
+      return entry->second->path;
+    }
+
+    if (directory.empty()) {
+      return std::nullopt;
+    }
+    std::FILE* file = std::fopen(file_path(key).c_str(), "rb");
+    if (file == nullptr) {
+      return std::nullopt;
+    }
+    auto path = deserialize_binary_path(file);
+    std::fclose(file);
+    if (!path || path->empty()) {
+      return std::nullopt;
+    }
+    ++disk_hits;
+    remember(key, *path);
+    return path;
+  }
+
+  /**
+   * Adds a path to the cache. If there is a directory, the path is written
+   * there and the copy read back from the file is kept in memory.
+   *
+   * @return The path as the cache will return it for this key.
+   */
+  std::vector<ProfilePoint> insert(const PathKey& key,
+                                   const std::vector<ProfilePoint>& path) {
+    if (!directory.empty()) {
+      if (auto stored = write_and_read_back(key, path)) {
+        remember(key, *stored);
+        return std::move(*stored);
+      }
+    }
+    remember(key, path);
+    return path;
+  }
+
+  /**
+   * Drops every path from memory. Files in the directory are kept.
+   */
+  void clear() {
+    entries.clear();
+    index.clear();
+    used_bytes = 0;
+  }
+
+  /**
+   * An estimate of the heap memory a path uses.
+   */
+  static std::size_t path_bytes(const std::vector<ProfilePoint>& path) {
+    std::size_t bytes = path.capacity() * sizeof(ProfilePoint);
+    for (const auto& p : path) {
+      bytes += p.wheel_velocities.capacity() * sizeof(double);
+    }
+    return bytes;
+  }
+
+  std::string file_path(const PathKey& key) const {
+    const bool slash = !directory.empty() && directory.back() == '/';
+    return directory + (slash ? "" : "/") + key.to_string() + ".bin";
+  }
+
+  std::size_t size() const {
+    return entries.size();
+  }
+
+  std::size_t bytes() const {
+    return used_bytes;
+  }
+
+  std::size_t memory_hits = 0;
+  std::size_t disk_hits = 0;
+  std::size_t misses = 0;
+
+  private:
+  struct Entry {
+    std::uint64_t hash;
+    std::vector<ProfilePoint> path;
+    std::size_t bytes;
+  };
+
+  /**
+   * Writes the path's file and reads it back, or returns std::nullopt and
+   * leaves no file if either fails.
+   */
+  std::optional<std::vector<ProfilePoint>>
+  write_and_read_back(const PathKey& key, const std::vector<ProfilePoint>& path) {
+    const std::string name = file_path(key);
+    std::FILE* file = std::fopen(name.c_str(), "wb");
+    if (file == nullptr) {
+      return std::nullopt;
+    }
+    const bool written = serialize_binary_path(file, path) == 0;
+    std::fclose(file);
+
+    std::optional<std::vector<ProfilePoint>> stored;
+    if (written && (file = std::fopen(name.c_str(), "rb")) != nullptr) {
+      stored = deserialize_binary_path(file);
+      std::fclose(file);
+    }
+    if (!stored || stored->empty()) {
+      std::remove(name.c_str());
+      return std::nullopt;
+    }
+    return stored;
+  }
+
+  void remember(const PathKey& key, const std::vector<ProfilePoint>& path) {
+    const std::size_t bytes = path_bytes(path);
+    const auto existing = index.find(key.hash);
+    if (existing != index.end()) {
+      used_bytes -= existing->second->bytes;
+      entries.erase(existing->second);
+      index.erase(existing);
+    }
+    if (bytes > max_bytes) {
+      return;
+    }
+    while (used_bytes + bytes > max_bytes && !entries.empty()) {
+      used_bytes -= entries.back().bytes;
+      index.erase(entries.back().hash);
+      entries.pop_back();
+    }
+    entries.push_front({key.hash, path, bytes});
+    index[key.hash] = entries.begin();
+    used_bytes += bytes;
+  }
+
+  std::size_t max_bytes;
+  std::string directory;
+  std::size_t used_bytes = 0;
+  // Most recently used first
+  std::list<Entry> entries;
+  std::unordered_map<std::uint64_t, std::list<Entry>::iterator> index;
+};
+} // namespace squiggles
+
+#endif
@@ -0,0 +1,185 @@
+/**
+ * Copyright 2020 Jonathan Bayless
+ *
+ * Use of this source code is governed by an MIT-style license that can be found
+ * in the LICENSE file or at https://opensource.org/licenses/MIT.
+ */
+#ifndef _PHYSICAL_MODEL_DC_MOTOR_TANK_MODEL_HPP_
+#define _PHYSICAL_MODEL_DC_MOTOR_TANK_MODEL_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "physicalmodel/physicalmodel.hpp"
+
+namespace squiggles {
+/**
+ * The linear torque-speed curve of a brushed DC motor, measured at the output
+ * shaft of the motor (after any cartridge or internal gearing).
+ */
+struct DCMotor {
+  /**
+   * @param istall_torque The torque at zero speed in Newton-meters.
+   * @param ifree_speed The speed with no load in radians per second.
+   * @param inominal_voltage The voltage both of the above were measured at.
+   */
+  DCMotor(double istall_torque, double ifree_speed, double inominal_voltage)
+    : stall_torque(istall_torque),
+      free_speed(ifree_speed),
+      nominal_voltage(inominal_voltage) {}
+
+  /**
+   * A V5 Smart Motor with the cartridge for the given free speed (100, 200
+   * or 600 RPM). The 11 W motor makes 2.1 Nm at stall through the 100 RPM
+   * cartridge, which is current-limited rather than voltage-limited.
+   */
+  static DCMotor v5(double cartridge_rpm) {
+    return DCMotor(2.1 * 100.0 / cartridge_rpm, cartridge_rpm * 2 * M_PI / 60, 12.0);
+  }
+
+  double stall_torque;
+  double free_speed;
+  double nominal_voltage;
+};
+
+class DCMotorTankModel : public PhysicalModel {
+  public:
+  /**
+   * Defines a tank drive whose limits come from its motors instead of fixed
+   * constraints. The acceleration available falls off as the wheels speed up,
+   * the same way the motor's torque does, so the path can accelerate hard
+   * from rest and still stay within what the motors can give near top speed.
+   *
+   * Each side of the drive is modeled as carrying half the robot's mass.
+   *
+   * @param itrack_width The distance between the left and right wheels in
+   *                     meters.
+   * @param imotor The motors driving the wheels.
+   * @param imotors_per_side The number of motors on each side of the drive.
+   * @param igear_ratio Wheel speed divided by motor speed, e.g. 36.0 / 60.0
+   *                    for a 36 tooth motor gear driving a 60 tooth wheel gear.
+   * @param iwheel_radius The radius of the wheels in meters.
+   * @param imass The mass of the robot in kilograms.
+   * @param ibattery_voltage The voltage the motors are driven at. Anything
+   *                         above the motor's nominal voltage is treated as
+   *                         the nominal voltage.
+   * @param ilinear_constraints Limits applied on top of the motors', such as
+   *                            a velocity cap for the path.
+   */
+  DCMotorTankModel(double itrack_width,
+                   DCMotor imotor,
+                   int imotors_per_side,
+                   double igear_ratio,
+                   double iwheel_radius,
+                   double imass,
+                   double ibattery_voltage,
+                   Constraints ilinear_constraints)
+    : track_width(itrack_width),
+      motor(imotor),
+      motors_per_side(imotors_per_side),
+      gear_ratio(igear_ratio),
+      wheel_radius(iwheel_radius),
+      mass(imass),
+      battery_voltage(ibattery_voltage),
+      linear_constraints(ilinear_constraints) {}
+
+  Constraints
+  constraints([[maybe_unused]] const Pose pose,
+              double curvature,
+              double vel) override {
+    // How fast each side moves relative to the center of the robot
+    const double left = 1 - curvature * track_width / 2;
+    const double right = 1 + curvature * track_width / 2;
+    const double fastest = std::max(std::fabs(left), std::fabs(right));
+
+    const double max_vel =
+      std::min(linear_constraints.max_vel, free_wheel_speed() / fastest);
+
+    double max_accel = linear_constraints.max_accel;
+    double max_decel = -linear_constraints.min_accel;
+    for (double side : {left, right}) {
+      if (std::fabs(side) < K_EPSILON) {
+        continue;
+      }
+      const double side_mass = mass / 2 * std::fabs(side);
+      max_accel =
+        std::min(max_accel, drive_force(std::fabs(vel * side)) / side_mass);
+      max_decel = std::min(max_decel, brake_force() / side_mass);
+    }
+
+    return Constraints(max_vel,
+                       max_accel,
+                       linear_constraints.max_jerk,
+                       linear_constraints.max_curvature,
+                       -max_decel);
+  }
+
+  std::vector<double> linear_to_wheel_vels(double lin_vel,
+                                           double curvature) override {
+    const double turn_vel = lin_vel * curvature * track_width / 2;
+    return std::vector<double>{lin_vel - turn_vel, lin_vel + turn_vel};
+  }
+
+  std::string to_string() const override {
+    return "DCMotorTankModel {track_width: " + std::to_string(track_width) +
+           ", stall_torque: " + std::to_string(motor.stall_torque) +
+           ", free_speed: " + std::to_string(motor.free_speed) +
+           ", motors_per_side: " + std::to_string(motors_per_side) +
+           ", gear_ratio: " + std::to_string(gear_ratio) +
+           ", wheel_radius: " + std::to_string(wheel_radius) +
+           ", mass: " + std::to_string(mass) +
+           ", battery_voltage: " + std::to_string(battery_voltage) +
+           ", linear_constraints: " + linear_constraints.to_string() + "}";
+  }
+
+  /**
+   * The fastest a wheel can move at the battery voltage, in meters per
+   * second.
+   */
+  double free_wheel_speed() const {
+    return motor.free_speed * voltage_scale() * gear_ratio * wheel_radius;
+  }
+
+  /**
+   * The force one side of the drive can push with while its wheels move at
+   * the given speed, in Newtons.
+   */
+  double drive_force(double wheel_speed) const {
+    const double torque = motor.stall_torque * voltage_scale() *
+                          (1 - wheel_speed / std::max(free_wheel_speed(), K_EPSILON));
+    return std::max(0.0, torque) * motors_per_side / (gear_ratio * wheel_radius);
+  }
+
+  /**
+   * The force one side of the drive can brake with, in Newtons. Driving
+   * against the direction of motion, the motor would be able to make more
+   * than its stall torque, so the stall torque (where the motor's current
+   * limit sits) is the limit at every speed.
+   */
+  double brake_force() const {
+    return motor.stall_torque * voltage_scale() * motors_per_side /
+           (gear_ratio * wheel_radius);
+  }
+
+  private:
+  double voltage_scale() const {
+    return std::clamp(battery_voltage / motor.nominal_voltage, 0.0, 1.0);
+  }
+
+  static constexpr double K_EPSILON = 1e-9;
+
+  double track_width;
+  DCMotor motor;
+  int motors_per_side;
+  double gear_ratio;
+  double wheel_radius;
+  double mass;
+  double battery_voltage;
+  Constraints linear_constraints;
+};
+} // namespace squiggles
+
+#endif
@@ -0,0 +1,274 @@
+/**
+ * Copyright 2020 Jonathan Bayless
+ *
+ * Use of this source code is governed by an MIT-style license that can be found
+ * in the LICENSE file or at https://opensource.org/licenses/MIT.
+ */
+#ifndef _PHYSICAL_MODEL_X_DRIVE_MODEL_HPP_
+#define _PHYSICAL_MODEL_X_DRIVE_MODEL_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "geometry/profilepoint.hpp"
+#include "physicalmodel/physicalmodel.hpp"
+
+namespace squiggles {
+/**
+ * One state of a holonomic path: where the robot is, which way it faces and
+ * what each wheel does, in the motor order of okapi::XDriveModel (top left,
+ * top right, bottom right, bottom left).
+ */
+struct XDriveState {
+  double time;
+  Pose pose;             // position, with yaw as the robot's heading
+  double vx;             // field frame velocity in meters per second
+  double vy;
+  double angular_vel;    // radians per second, counterclockwise
+  std::array<double, 4> wheel_velocities;
+};
+
+class XDrivePhysicalModel : public PhysicalModel {
+  public:
+  /**
+   * Defines an X-drive: four omni wheels at the corners, each mounted at 45
+   * degrees. An X-drive can translate in any direction while turning
+   * independently, so the path's curvature does not have to be turned into.
+   *
+   * The path generated with this model is the translation profile. The
+   * heading is profiled separately by combine(). Each wheel's velocity and
+   * acceleration budget is split between them by iturn_share, so the two
+   * profiles can never ask a wheel for more than it has together.
+   *
+   * @param iwheel_distance The distance from the center of the robot to each
+   *                        wheel in meters.
+   * @param iwheel_constraints The fastest velocity and acceleration of each
+   *                           wheel along its rolling direction.
+   * @param iturn_share The fraction of each wheel's budget kept for turning,
+   *                    in [0, 1). With 0 the robot can not turn, so every
+   *                    path has to keep its heading.
+   * @param iheading The heading the robot holds for the whole path in
+   *                 radians, or NaN if it may turn during the path. A fixed
+   *                 heading lets constraints() use the real direction of
+   *                 travel relative to the robot instead of the worst case,
+   *                 and combine() then only accepts that heading.
+   * @throws std::invalid_argument if iturn_share is outside [0, 1).
+   */
+  XDrivePhysicalModel(double iwheel_distance,
+                      Constraints iwheel_constraints,
+                      double iturn_share = 0.25,
+                      double iheading = std::nan(""))
+    : wheel_distance(iwheel_distance),
+      wheel_constraints(iwheel_constraints),
+      turn_share(iturn_share),
+      heading(iheading) {
+    if (!(iturn_share >= 0 && iturn_share < 1)) {
+      throw std::invalid_argument(
+        "XDrivePhysicalModel: turn_share must be in [0, 1), got " +
+        std::to_string(iturn_share));
+    }
+  }
+
+  /**
+   * Limits translation along the path. Moving straight forward spreads the
+   * motion over all four wheels, while moving diagonally puts it on two, so
+   * the limits depend on the direction of travel relative to the robot. If
+   * the model has no fixed heading the robot may face anywhere while
+   * translating and the diagonal (worst) case is used.
+   */
+  Constraints constraints(const Pose pose, double curvature, double vel) override {
+    const double budget_vel = (1 - turn_share) * wheel_constraints.max_vel;
+    const double budget_accel = (1 - turn_share) * wheel_constraints.max_accel;
+
+    double along = 1;
+    double across = 1;
+    if (!std::isnan(heading)) {
+      const double phi = pose.yaw - heading;
+      along = wheel_share(phi);
+      across = wheel_share(phi + M_PI / 2);
+    }
+
+    // The wheels also have to provide the centripetal acceleration
+    const double centripetal = vel * vel * std::fabs(curvature) * across;
+    const double max_accel =
+      std::max(0.0, budget_accel - centripetal) / along;
+
+    double max_vel = budget_vel / along;
+    if (std::fabs(curvature) > 1e-9) {
+      max_vel =
+        std::min(max_vel, std::sqrt(budget_accel / (std::fabs(curvature) * across)));
+    }
+
+    return Constraints(max_vel,
+                       max_accel,
+                       wheel_constraints.max_jerk,
+                       wheel_constraints.max_curvature,
+                       -max_accel);
+  }
+
+  /**
+   * The wheel velocities for moving along the robot's own heading. This
+   * interface is not told the direction of travel, so use combine() for the
+   * wheel velocities of a holonomic path.
+   */
+  std::vector<double> linear_to_wheel_vels(double lin_vel,
+                                           [[maybe_unused]] double curvature) override {
+    const auto w = wheel_vels(lin_vel, 0, 0);
+    return std::vector<double>(w.begin(), w.end());
+  }
+
+  std::string to_string() const override {
+    return "XDrivePhysicalModel {wheel_distance: " +
+           std::to_string(wheel_distance) +
+           ", turn_share: " + std::to_string(turn_share) +
+           ", heading: " + std::to_string(heading) +
+           ", wheel_constraints: " + wheel_constraints.to_string() + "}";
+  }
+
+  /**
+   * The wheel velocities for a velocity in the robot's frame.
+   *
+   * @param forward Meters per second along the robot's heading.
+   * @param left Meters per second to the robot's left.
+   * @param angular_vel Radians per second, counterclockwise.
+   */
+  std::array<double, 4>
+  wheel_vels(double forward, double left, double angular_vel) const {
+    const double a = (forward - left) / M_SQRT2;
+    const double b = (forward + left) / M_SQRT2;
+    const double turn = angular_vel * wheel_distance;
+    return {a - turn, b + turn, a + turn, b - turn};
+  }
+
+  /**
+   * Combines a translation profile generated with this model and a turn from
+   * start_heading to end_heading into one holonomic path. The turn is a
+   * trapezoidal profile using the turning share of the wheel budget. It runs
+   * alongside the translation and, if it needs longer, the robot holds its
+   * final position until the turn is done.
+   *
+   * @param path The translation profile from SplineGenerator::generate
+   * @param start_heading The robot's heading at the start in radians
+   * @param end_heading The heading to finish at in radians
+   * @throws std::invalid_argument if the heading changes but the model keeps
+   *         no turning budget (turn_share is 0), or if the model has a fixed
+   *         heading and start_heading or end_heading is not that heading. The
+   *         path was limited for that heading only, so turning away from it
+   *         could ask the wheels for more than they have.
+   */
+  std::vector<XDriveState> combine(const std::vector<ProfilePoint>& path,
+                                   double start_heading,
+                                   double end_heading) const {
+    if (!std::isnan(heading) &&
+        (std::fabs(std::remainder(start_heading - heading, 2 * M_PI)) > 1e-9 ||
+         std::fabs(std::remainder(end_heading - heading, 2 * M_PI)) > 1e-9)) {
+      throw std::invalid_argument(
+        "XDrivePhysicalModel::combine: the model holds heading " +
+        std::to_string(heading) + " rad, but the path turns from " +
+        std::to_string(start_heading) + " to " + std::to_string(end_heading) +
+        " rad");
+    }
+
+    std::vector<XDriveState> out;
+    if (path.empty()) {
+      return out;
+    }
+
+    const double turn = std::remainder(end_heading - start_heading, 2 * M_PI);
+    const double max_omega = turn_share * wheel_constraints.max_vel / wheel_distance;
+    const double max_alpha = turn_share * wheel_constraints.max_accel / wheel_distance;
+    const double start_time = path.front().time;
+    const double period =
+      path.size() > 1 ? path[1].time - path[0].time : 0.01;
+
+    // Trapezoidal turn: accelerate, cruise, decelerate
+    const double distance = std::fabs(turn);
+    double accel_time = 0;
+    double peak = 0;
+    double cruise_time = 0;
+    if (distance > 0) {
+      if (turn_share == 0) {
+        throw std::invalid_argument(
+          "XDrivePhysicalModel::combine: the heading changes by " +
+          std::to_string(turn) + " rad but turn_share is 0");
+      }
+      accel_time = std::min(max_omega / max_alpha, std::sqrt(distance / max_alpha));
+      peak = max_alpha * accel_time;
+      cruise_time =
+        peak > 0 ? (distance - max_alpha * accel_time * accel_time) / peak : 0;
+    }
+    const double turn_time = 2 * accel_time + cruise_time;
+    const double sign = turn < 0 ? -1 : 1;
+
+    const auto turn_at = [&](double t, double& angle, double& omega) {
+      t = std::clamp(t, 0.0, turn_time);
+      if (t < accel_time) {
+        omega = max_alpha * t;
+        angle = max_alpha * t * t / 2;
+      } else if (t < accel_time + cruise_time) {
+        omega = peak;
+        angle = peak * accel_time / 2 + peak * (t - accel_time);
+      } else {
+        const double r = turn_time - t;
+        omega = max_alpha * r;
+        angle = distance - max_alpha * r * r / 2;
+      }
+      angle = start_heading + sign * angle;
+      omega *= sign;
+    };
+
+    const double path_time = path.back().time - start_time;
+    const std::size_t extra =
+      turn_time > path_time && period > 0
+        ? static_cast<std::size_t>(std::ceil((turn_time - path_time) / period))
+        : 0;
+    out.reserve(path.size() + extra);
+
+    for (std::size_t i = 0; i < path.size() + extra; ++i) {
+      const ProfilePoint& p = path[std::min(i, path.size() - 1)];
+      const bool holding = i >= path.size();
+      const double t = holding ? path_time + (i - path.size() + 1) * period
+                               : p.time - start_time;
+      const double v = holding ? 0.0 : p.vector.vel;
+
+      double angle, omega;
+      turn_at(t, angle, omega);
+
+      const double vx = v * std::cos(p.vector.pose.yaw);
+      const double vy = v * std::sin(p.vector.pose.yaw);
+      // Rotate the field velocity into the robot's frame
+      const double forward = vx * std::cos(angle) + vy * std::sin(angle);
+      const double left = -vx * std::sin(angle) + vy * std::cos(angle);
+
+      out.push_back({start_time + t,
+                     Pose(p.vector.pose.x, p.vector.pose.y, angle),
+                     vx,
+                     vy,
+                     omega,
+                     wheel_vels(forward, left, omega)});
+    }
+    return out;
+  }
+
+  private:
+  /**
+   * How much of the busiest wheel's speed one meter per second of travel at
+   * angle phi (relative to the robot) uses.
+   */
+  static double wheel_share(double phi) {
+    return std::max(std::fabs(std::cos(phi + M_PI / 4)),
+                    std::fabs(std::cos(phi - M_PI / 4)));
+  }
+
+  double wheel_distance;
+  Constraints wheel_constraints;
+  double turn_share;
+  double heading;
+};
+} // namespace squiggles
+
+#endif
@@ -8,15 +8,27 @@
 #define _ROBOT_SQUIGGLES_H_
 
 #include "geometry/controlvector.hpp"
+#include "geometry/packedprofile.hpp"
+#include "geometry/profilebuffer.hpp"
 #include "geometry/pose.hpp"
 #include "geometry/profilepoint.hpp"
+#include "geometry/uniformprofile.hpp"
 
+#include "physicalmodel/dcmotortankmodel.hpp"
 #include "physicalmodel/passthroughmodel.hpp"
 #include "physicalmodel/physicalmodel.hpp"
 #include "physicalmodel/tankmodel.hpp"
+#include "physicalmodel/xdrivemodel.hpp"
 
+#include "adaptivespline.hpp"
+#include "binaryio.hpp"
 #include "constraints.hpp"
+#include "gridplanner.hpp"
+#include "incrementalspline.hpp"
 #include "io.hpp"
+#include "jerklimitedspline.hpp"
+#include "parallelspline.hpp"
+#include "pathcache.hpp"
 #include "spline.hpp"
 
 #endif
\ No newline at end of file
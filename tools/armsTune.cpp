@@ -0,0 +1,35 @@
+/**
+ * \file armsTune.cpp
+ * Offline tuner for the ARMS PID gains. Runs on a computer, not the brain, and
+ * prints lines to paste into include/ARMS/config.h.
+ *
+ * Build and run from the project root:
+ *   g++ -std=gnu++17 -O2 -DTHREADS_STD -pthread -Iinclude tools/armsTune.cpp -o armsTune
+ *   ./armsTune [max speed in/s] [time constant s]
+ */
+#include "ARMS/tuner.h"
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char** argv) {
+	arms::tuner::DrivetrainModel model;
+	if (argc > 1)
+		model.maxSpeed = std::atof(argv[1]);
+	if (argc > 2)
+		model.timeConstant = std::atof(argv[2]);
+
+	// The controllers take the derivative per 10 ms tick, so kD needs to be
+	// several times kP. The model has no sensor noise, so the linear kP keeps
+	// rising with its bound: its upper bound sets how stiff the result is.
+	arms::tuner::Tuner linear(model, {0, 40}, {0, 0.2}, {0, 1000});
+	arms::tuner::Tuner angular(model, {0, 40}, {0, 0.5}, {0, 400});
+
+	auto lin = linear.tuneLinear();
+	auto ang = angular.tuneAngular();
+
+	printf("// linear: settle %.2fs, itae %.2f\n", lin.score.settleTime,
+	       lin.score.itae);
+	printf("// angular: settle %.2fs, itae %.2f\n", ang.score.settleTime,
+	       ang.score.itae);
+	printf("%s", arms::tuner::Tuner::configLines(lin.gains, ang.gains).c_str());
+}
@@ -0,0 +1,153 @@
+/**
+ * \file blockfilterbench.cpp
+ * Checks that filtering a signal in blocks gives exactly the outputs of
+ * streaming it one reading at a time, and times the two. Each filter is run
+ * over the signal:
+ *  - streamed: one virtual filter() call per reading, through a Filter&
+ *  - in blocks of several sizes, including blocks that don't divide the
+ *    signal, blocks filtered in place and single readings mixed in between
+ *  - as a subclass which overrides filter(), whose blocks must go through the
+ *    override
+ * Every run must match the streamed outputs and final getOutput() bit for bit.
+ *
+ * AverageFilter and MedianFilter are checked here because they are header
+ * only. The other filters' filter() is compiled into the okapilib archive,
+ * which is not linked on a host, but their block overloads are the same loop.
+ *
+ * Build and run from the project root:
+ *   g++ -std=gnu++17 -O2 -Iinclude tools/blockfilterbench.cpp -o blockfilterbench
+ *   ./blockfilterbench
+ */
+#include "okapi/api/filter/averageFilter.hpp"
+#include "okapi/api/filter/medianFilter.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Filter's destructor is compiled into the okapilib archive, which is not linked here
+okapi::Filter::~Filter() = default;
+
+/**
+ * A subclass which changes filter(), so its blocks can't skip the override
+ */
+template <class Base> class Offset : public Base {
+	public:
+	double filter(double ireading) override {
+		return Base::filter(ireading) + 1;
+	}
+	using Base::filter;
+};
+
+// Keeps the timed loops from being optimized away
+static volatile double sink;
+
+// Not inlined, so the compiler can't see the filter's type and drop the virtual calls
+__attribute__((noinline)) static void stream(okapi::Filter& filter, const std::vector<double>& in,
+                                             std::vector<double>& out) {
+	for (std::size_t i = 0; i < in.size(); i++)
+		out[i] = filter.filter(in[i]);
+}
+
+static bool same(const std::vector<double>& a, const std::vector<double>& b) {
+	return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0;
+}
+
+/**
+ * Filters the signal in blocks of the given size. With inPlace the block is
+ * copied to the output first and filtered there. Every mixEvery blocks, one
+ * reading goes through filter(double) instead.
+ */
+template <class F>
+static double blocks(F& filter, const std::vector<double>& in, std::vector<double>& out,
+                     std::size_t size, bool inPlace, std::size_t mixEvery) {
+	std::size_t i = 0;
+	for (std::size_t block = 0; i < in.size(); block++) {
+		if (mixEvery > 0 && block % mixEvery == mixEvery - 1) {
+			out[i] = filter.filter(in[i]);
+			i++;
+			continue;
+		}
+		const std::size_t n = std::min(size, in.size() - i);
+		if (inPlace) {
+			std::copy(in.begin() + i, in.begin() + i + n, out.begin() + i);
+			filter.filter(out.data() + i, out.data() + i, n);
+		} else {
+			filter.filter(in.data() + i, out.data() + i, n);
+		}
+		i += n;
+	}
+	return filter.getOutput();
+}
+
+template <class F> static bool check(const char* name, const std::vector<double>& signal) {
+	std::vector<double> expected(signal.size());
+	std::vector<double> out(signal.size());
+
+	F streamed;
+	stream(streamed, signal, expected);
+
+	bool ok = true;
+	const struct {
+		std::size_t size;
+		bool inPlace;
+		std::size_t mixEvery;
+	} splits[] = {{1, false, 0},   {7, false, 0},    {64, true, 0},
+	              {1000, false, 3}, {4093, true, 5}, {signal.size(), false, 0}};
+	for (const auto& split : splits) {
+		F filter;
+		const double last = blocks(filter, signal, out, split.size, split.inPlace, split.mixEvery);
+		if (!same(out, expected) || last != streamed.getOutput()) {
+			std::printf("%s: blocks of %zu%s%s differ from streaming\n", name, split.size,
+			            split.inPlace ? " in place" : "", split.mixEvery ? " mixed" : "");
+			ok = false;
+		}
+	}
+
+	Offset<F> overridden;
+	Offset<F> overriddenStreamed;
+	std::vector<double> overriddenExpected(signal.size());
+	stream(overriddenStreamed, signal, overriddenExpected);
+	blocks(overridden, signal, out, 100, false, 0);
+	if (!same(out, overriddenExpected)) {
+		std::printf("%s: a subclass's blocks skip its filter() override\n", name);
+		ok = false;
+	}
+
+	const int reps = 20;
+	double streamNs = 0, blockNs = 0;
+	for (int r = 0; r < reps; r++) {
+		F a, b;
+		auto start = std::chrono::steady_clock::now();
+		stream(a, signal, out);
+		auto mid = std::chrono::steady_clock::now();
+		b.filter(signal.data(), out.data(), signal.size());
+		auto end = std::chrono::steady_clock::now();
+		sink = a.getOutput() + b.getOutput();
+		streamNs += std::chrono::duration<double, std::nano>(mid - start).count();
+		blockNs += std::chrono::duration<double, std::nano>(end - mid).count();
+	}
+	const double per = double(reps) * signal.size();
+	std::printf("%-18s %12.2f %12.2f %8.2fx %6s\n", name, streamNs / per, blockNs / per,
+	            streamNs / blockNs, ok ? "yes" : "NO");
+	return ok;
+}
+
+int main() {
+	std::mt19937 rng(3);
+	std::normal_distribution<double> noise(0, 3);
+	std::vector<double> signal;
+	for (int i = 0; i < 200000; i++)
+		signal.push_back(50 * std::sin(i * 0.002) + noise(rng));
+
+	std::printf("%-18s %12s %12s %9s %6s\n", "filter", "stream ns", "block ns", "speedup",
+	            "same");
+	bool ok = check<okapi::AverageFilter<4>>("AverageFilter<4>", signal);
+	ok &= check<okapi::AverageFilter<16>>("AverageFilter<16>", signal);
+	ok &= check<okapi::MedianFilter<5>>("MedianFilter<5>", signal);
+	ok &= check<okapi::MedianFilter<15>>("MedianFilter<15>", signal);
+	return ok ? 0 : 1;
+}
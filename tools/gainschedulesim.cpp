@@ -0,0 +1,99 @@
+/**
+ * \file gainschedulesim.cpp
+ * Compares constant gains with a gain schedule on simulated drives of several
+ * lengths. For each length it prints the time to settle and the overshoot of:
+ *  - config: the default LINEAR_KP/KI/KD from ARMS/config.h
+ *  - tuned: one set of gains tuned over every length at once
+ *  - schedule: a GainSchedule with a row of gains tuned for each length
+ *
+ * The drivetrain is the default arms::tuner::DrivetrainModel and a move
+ * settles once it stays within the tuner's settle window, the same rule
+ * armsTune scores gains by.
+ *
+ * Build and run from the project root:
+ *   g++ -std=gnu++17 -O2 -DTHREADS_STD -pthread -Iinclude tools/gainschedulesim.cpp -o gainschedulesim
+ *   ./gainschedulesim
+ */
+#include "ARMS/tuner.h"
+#include <cstdio>
+#include <vector>
+
+using namespace arms;
+
+static const double LENGTHS[] = {5, 12, 24, 40};
+
+// the same search ranges as armsTune
+static const tuner::Tuner::Range KP{0, 40};
+static const tuner::Tuner::Range KI{0, 0.2};
+static const tuner::Tuner::Range KD{0, 1000};
+
+struct Run {
+	double settleTime;
+	double overshoot;
+};
+
+static Run drive(const tuner::DrivetrainModel& model, const tuner::Tuner& rules,
+                 const pid::GainSchedule& gains, double length) {
+	pid::TranslationalController c(gains, rules.trackingKP, rules.minError);
+	tuner::DrivetrainSim sim(model);
+	c.setTarget({length, 0}, sim.position());
+
+	Run run{0, 0};
+	double settledFor = 0;
+	while (run.settleTime < rules.timeout && settledFor < rules.settleTime) {
+		auto out = c.step(sim.position(), sim.heading());
+		sim.step(out[0], out[1]);
+		double error = length - sim.position().x;
+		run.settleTime += model.dt;
+		run.overshoot = std::fmax(run.overshoot, -error);
+		settledFor = std::fabs(error) < rules.settleError ? settledFor + model.dt : 0;
+	}
+	return run;
+}
+
+static void report(const char* name, const tuner::DrivetrainModel& model,
+                   const tuner::Tuner& rules, const pid::GainSchedule& gains) {
+	std::printf("%-9s", name);
+	double total = 0;
+	for (double length : LENGTHS) {
+		Run run = drive(model, rules, gains, length);
+		std::printf("  %5.2fs %5.2fin", run.settleTime, run.overshoot);
+		total += run.settleTime;
+	}
+	std::printf("  %6.2fs\n", total);
+}
+
+int main() {
+	tuner::DrivetrainModel model;
+
+	tuner::Tuner all(model, KP, KI, KD);
+	all.moves.assign(std::begin(LENGTHS), std::end(LENGTHS));
+	pid::Gains tuned = all.tuneLinear().gains;
+
+	std::vector<pid::Gains> rows;
+	for (double length : LENGTHS) {
+		tuner::Tuner one(model, KP, KI, KD);
+		one.moves = {length};
+		rows.push_back(one.tuneLinear().gains);
+	}
+	pid::GainSchedule schedule{{LENGTHS[0], rows[0]},
+	                           {LENGTHS[1], rows[1]},
+	                           {LENGTHS[2], rows[2]},
+	                           {LENGTHS[3], rows[3]}};
+
+	std::printf("gains (kP kI kD)\n");
+	std::printf("  tuned     %7.3f %6.4f %8.3f\n", tuned.kP, tuned.kI, tuned.kD);
+	for (std::size_t i = 0; i < rows.size(); i++)
+		std::printf("  %2.0f in     %7.3f %6.4f %8.3f\n", LENGTHS[i], rows[i].kP,
+		            rows[i].kI, rows[i].kD);
+
+	std::printf("\nsettle time and overshoot per move length\n%-9s", "");
+	for (double length : LENGTHS)
+		std::printf("%14.0fin", length);
+	std::printf("  %7s\n", "total");
+
+	report("config", model, all, pid::Gains{2, 0.02, 0.9});
+	report("tuned", model, all, tuned);
+	report("schedule", model, all, schedule);
+	return 0;
+}
@@ -0,0 +1,203 @@
+/**
+ * \file geombench.cpp
+ * Counts the transcendental calls (sin, cos, sincos and atan2, in float and
+ * double) made by the ARMS geometry kernels and times them, side by side with
+ * the angle-based code they replace:
+ *  - odom step: arcStep on an OdomPose, which stores its heading as an angle,
+ *    against arcStep on a Pose2, which caches the heading's cos and sin
+ *  - to robot frame: a field point into the robot frame through cos/sin of
+ *    the heading, against Pose2::inverse()
+ *  - small rotation: std::cos/std::sin of a control-step angle, against
+ *    Rot2::fromAngle
+ *
+ * The calls are counted by defining the math functions in this file, which
+ * forward to the C library's. Forwarding adds about a nanosecond to every
+ * call, so the timings slightly favour the kernels that make fewer calls.
+ * The inputs replay a 4 s S-curve drive at 10 ms per step.
+ *
+ * Build and run from the project root, on Linux with glibc:
+ *   g++ -std=gnu++17 -O2 -Iinclude tools/geombench.cpp -o geombench -ldl
+ *   ./geombench
+ */
+#include "ARMS/odomMath.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <dlfcn.h>
+#include <vector>
+
+// volatile, because the compiler assumes the math functions touch no memory
+static volatile unsigned long calls;
+
+template <typename F> static F real(const char* name) {
+	return reinterpret_cast<F>(dlsym(RTLD_NEXT, name));
+}
+
+extern "C" {
+double sin(double x) {
+	static auto f = real<double (*)(double)>("sin");
+	calls = calls + 1;
+	return f(x);
+}
+double cos(double x) {
+	static auto f = real<double (*)(double)>("cos");
+	calls = calls + 1;
+	return f(x);
+}
+void sincos(double x, double* s, double* c) {
+	static auto f = real<void (*)(double, double*, double*)>("sincos");
+	calls = calls + 1;
+	f(x, s, c);
+}
+double atan2(double y, double x) {
+	static auto f = real<double (*)(double, double)>("atan2");
+	calls = calls + 1;
+	return f(y, x);
+}
+float sinf(float x) {
+	static auto f = real<float (*)(float)>("sinf");
+	calls = calls + 1;
+	return f(x);
+}
+float cosf(float x) {
+	static auto f = real<float (*)(float)>("cosf");
+	calls = calls + 1;
+	return f(x);
+}
+void sincosf(float x, float* s, float* c) {
+	static auto f = real<void (*)(float, float*, float*)>("sincosf");
+	calls = calls + 1;
+	f(x, s, c);
+}
+float atan2f(float y, float x) {
+	static auto f = real<float (*)(float, float)>("atan2f");
+	calls = calls + 1;
+	return f(y, x);
+}
+}
+
+struct Step {
+	double forward;
+	double dtheta;
+};
+
+/**
+ * The per-step wheel travel of an S-curve drive at 40 in/s, in inches and
+ * radians
+ */
+static std::vector<Step> makeDrive() {
+	std::vector<Step> steps;
+	for (int i = 0; i < 400; i++) {
+		const double t = i * 0.01;
+		steps.push_back({0.4, 0.01 * 2.5 * std::sin(2 * M_PI * t / 2)});
+	}
+	return steps;
+}
+
+// Keeps the timed loops from being optimized away
+static volatile double sink;
+
+/**
+ * Run body once per step to count its calls, then many more times to time
+ * it. body returns a value that depends on all of its work.
+ */
+template <typename Body>
+static void run(const char* name, const std::vector<Step>& steps, Body body) {
+	calls = 0;
+	sink = body(steps);
+	const double perStep = double(calls) / steps.size();
+
+	const int reps = 2000;
+	const auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < reps; r++)
+		sink = body(steps);
+	const auto end = std::chrono::steady_clock::now();
+	std::printf("  %-24s %8.2f %10.2f\n", name, perStep,
+	            std::chrono::duration<double, std::nano>(end - start).count() /
+	                (double(reps) * steps.size()));
+}
+
+template <typename T> static void odomStep(const std::vector<Step>& steps) {
+	run("OdomPose arcStep", steps, [](const std::vector<Step>& s) {
+		arms::odom::OdomPose<T> p{0, 0, 0};
+		for (const Step& step : s)
+			arms::odom::arcStep(p, T(step.forward), T(0), T(step.dtheta));
+		return double(p.x + p.y + p.theta);
+	});
+	run("Pose2 arcStep", steps, [](const std::vector<Step>& s) {
+		arms::Pose2<T> p;
+		for (const Step& step : s)
+			arms::odom::arcStep(p, T(step.forward), T(0), T(step.dtheta));
+		return double(p.t.x + p.t.y + p.r.s);
+	});
+}
+
+template <typename T> static void toRobotFrame(const std::vector<Step>& steps) {
+	// the poses along the drive, in both representations
+	std::vector<arms::odom::OdomPose<T>> angles;
+	std::vector<arms::Pose2<T>> poses;
+	arms::odom::OdomPose<T> a{0, 0, 0};
+	arms::Pose2<T> p;
+	for (const Step& step : steps) {
+		arms::odom::arcStep(a, T(step.forward), T(0), T(step.dtheta));
+		arms::odom::arcStep(p, T(step.forward), T(0), T(step.dtheta));
+		angles.push_back(a);
+		poses.push_back(p);
+	}
+	const arms::Vec2<T> target(T(48), T(24));
+
+	run("angle, cos/sin", steps, [&](const std::vector<Step>&) {
+		T sum = 0;
+		for (const auto& pose : angles) {
+			const T dx = target.x - pose.x;
+			const T dy = target.y - pose.y;
+			const T c = std::cos(pose.theta);
+			const T s = std::sin(pose.theta);
+			sum += c * dx + s * dy - s * dx + c * dy;
+		}
+		return double(sum);
+	});
+	run("Pose2::inverse", steps, [&](const std::vector<Step>&) {
+		T sum = 0;
+		for (const auto& pose : poses) {
+			const arms::Vec2<T> local = pose.inverse() * target;
+			sum += local.x + local.y;
+		}
+		return double(sum);
+	});
+}
+
+template <typename T> static void smallRotation(const std::vector<Step>& steps) {
+	run("std::cos/std::sin", steps, [](const std::vector<Step>& s) {
+		T sum = 0;
+		for (const Step& step : s)
+			sum += std::cos(T(step.dtheta)) + std::sin(T(step.dtheta));
+		return double(sum);
+	});
+	run("Rot2::fromAngle", steps, [](const std::vector<Step>& s) {
+		T sum = 0;
+		for (const Step& step : s) {
+			const arms::Rot2<T> r = arms::Rot2<T>::fromAngle(T(step.dtheta));
+			sum += r.c + r.s;
+		}
+		return double(sum);
+	});
+}
+
+template <typename T> static void suite(const char* name,
+                                        const std::vector<Step>& steps) {
+	std::printf("%s\n  %-24s %8s %10s\n", name, "", "calls", "ns/step");
+	std::printf(" odom step\n");
+	odomStep<T>(steps);
+	std::printf(" to robot frame\n");
+	toRobotFrame<T>(steps);
+	std::printf(" small rotation\n");
+	smallRotation<T>(steps);
+}
+
+int main() {
+	const std::vector<Step> steps = makeDrive();
+	suite<double>("double", steps);
+	suite<float>("float", steps);
+	return 0;
+}
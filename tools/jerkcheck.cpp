@@ -0,0 +1,78 @@
+/**
+ * \file jerkcheck.cpp
+ * Checks JerkLimitedSplineGenerator on a few field paths. Every profile must
+ * keep its jerk within max_jerk, its wheel speeds within max_vel and its
+ * acceleration within TankModel's limit at each point's curvature. It must
+ * also take no longer than a plain trapezoidal profile whose acceleration is
+ * scaled down by the slip margin, which is how a path without a jerk limit
+ * would be made drivable without wheel slip. Exits with 1 if a check fails.
+ *
+ * Build against a host build of the squiggles sources that ship with okapilib,
+ * then run from the project root:
+ *   g++ -std=gnu++17 -O2 -Iinclude -iquote include/okapi/squiggles \
+ *       tools/jerkcheck.cpp <squiggles sources> -o jerkcheck
+ *   ./jerkcheck [slip margin, default 0.6]
+ */
+#include "squiggles.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using squiggles::Pose;
+
+int main(int argc, char** argv) {
+	const double margin = argc > 1 ? std::atof(argv[1]) : 0.6;
+	const double trackWidth = 0.3;
+	const double maxVel = 1.5;
+	const double maxAccel = 3.0;
+	const double maxJerk = 20.0;
+
+	std::vector<std::vector<Pose>> paths{
+	    {Pose(0, 0, 0), Pose(2.5, 0, 0)},
+	    {Pose(0, 0, 0), Pose(1.2, 0.6, 0), Pose(2.4, 0, 0)},
+	    {Pose(0, 0, 0), Pose(1, 0.3, 0.5), Pose(1.8, 1.2, 1.57),
+	     Pose(1.2, 2, 3.14)},
+	};
+
+	squiggles::Constraints limited(maxVel, maxAccel, maxJerk);
+	squiggles::JerkLimitedSplineGenerator generator(
+	    limited, std::make_shared<squiggles::TankModel>(trackWidth, limited),
+	    0.01);
+
+	squiggles::Constraints scaled(maxVel, maxAccel * margin);
+	squiggles::JerkLimitedSplineGenerator trapezoid(
+	    scaled, std::make_shared<squiggles::TankModel>(trackWidth, scaled), 0.01);
+
+	bool ok = true;
+	for (std::size_t i = 0; i < paths.size(); i++) {
+		auto path = generator.generate_jerk_limited(paths[i]);
+		auto reference = trapezoid.generate_jerk_limited(paths[i]);
+		if (path.empty() || reference.empty()) {
+			std::printf("path %zu: could not be generated  FAIL\n", i);
+			ok = false;
+			continue;
+		}
+
+		double jerk = 0;
+		double wheel = 0;
+		// the largest share of its acceleration limit any point uses
+		double accel = 0;
+		for (const auto& p : path) {
+			jerk = std::max(jerk, std::fabs(p.vector.jerk));
+			for (double w : p.wheel_velocities)
+				wheel = std::max(wheel, std::fabs(w));
+			const double limit = maxAccel / (1 + std::fabs(p.curvature) * trackWidth / 2);
+			accel = std::max(accel, std::fabs(p.vector.accel) / limit);
+		}
+
+		bool pass = jerk <= maxJerk * (1 + 1e-6) && wheel <= maxVel * (1 + 1e-6) &&
+		            accel <= 1 + 1e-6 && path.back().time <= reference.back().time + 1e-9;
+		ok = ok && pass;
+		std::printf("path %zu: jerk %.3f / %.3f, wheel %.3f / %.3f, accel %.1f%% of limit, "
+		            "time %.2f s vs %.2f s trapezoid at %.0f%% accel  %s\n",
+		            i, jerk, maxJerk, wheel, maxVel, accel * 100, path.back().time,
+		            reference.back().time, margin * 100, pass ? "ok" : "FAIL");
+	}
+	return ok ? 0 : 1;
+}
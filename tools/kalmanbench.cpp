@@ -0,0 +1,184 @@
+/**
+ * \file kalmanbench.cpp
+ * Times okapi::KalmanFilter on a 5 state drivetrain model: position, heading, linear and angular
+ * velocity, predicted with the nonlinear unicycle model and its Jacobian, and updated from both
+ * wheel velocities and a gyro. It reports the mean and worst time of a predict, an update and a
+ * whole step, and how much of a 10 ms (100 Hz) loop a step takes. It also checks that the
+ * estimate tracks a simulated robot better than the raw sensors do and, on a computer, that no
+ * step allocates. Exits with 1 if either check fails.
+ *
+ * On a computer, build and run from the project root:
+ *   g++ -std=gnu++17 -O2 -Iinclude tools/kalmanbench.cpp -o kalmanbench
+ *   ./kalmanbench
+ *
+ * On the brain, copy this file into src/ for one build and call kalmanBench() from initialize().
+ * The results are printed to the terminal.
+ */
+#include "okapi/api/filter/kalmanFilter.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+#ifdef __arm__
+#include "pros/rtos.h"
+
+static std::uint64_t nowNanos() {
+	return pros::c::micros() * 1000;
+}
+#else
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+static std::uint64_t nowNanos() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+	         std::chrono::steady_clock::now().time_since_epoch())
+	  .count();
+}
+
+// Counts every heap allocation, so the step loop can check that it makes none
+static std::size_t allocations = 0;
+
+void* operator new(std::size_t size) {
+	allocations++;
+	if (void* p = std::malloc(size ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+#endif
+
+static const double DT = 0.01;
+static const double TRACK = 0.3;
+
+using Filter = okapi::KalmanFilter<5, 2, 3>;
+using State = Filter::State;
+using Input = Filter::Input;
+using Measurement = Filter::Measurement;
+
+/**
+ * State is x, y, theta, linear velocity, angular velocity; the input is the commanded linear and
+ * angular acceleration. Okapi's frame: +y is to the right and theta is clockwise.
+ */
+static State model(const State& x, const Input& u) {
+	return {x[0] + x[3] * std::cos(x[2]) * DT,
+	        x[1] + x[3] * std::sin(x[2]) * DT,
+	        x[2] + x[4] * DT,
+	        x[3] + u[0] * DT,
+	        x[4] + u[1] * DT};
+}
+
+static Filter::StateMatrix jacobian(const State& x, const Input&) {
+	auto F = Filter::StateMatrix::identity();
+	F(0, 2) = -x[3] * std::sin(x[2]) * DT;
+	F(0, 3) = std::cos(x[2]) * DT;
+	F(1, 2) = x[3] * std::cos(x[2]) * DT;
+	F(1, 3) = std::sin(x[2]) * DT;
+	F(2, 4) = DT;
+	return F;
+}
+
+struct Timing {
+	std::uint64_t total = 0;
+	std::uint64_t worst = 0;
+
+	void add(std::uint64_t ns) {
+		total += ns;
+		if (ns > worst)
+			worst = ns;
+	}
+};
+
+static void report(const char* name, const Timing& t, int steps) {
+	const double mean = double(t.total) / steps;
+	std::printf("%-8s %10.0f %10.0f %8.2f%%\n", name, mean, double(t.worst), mean / 1e5);
+}
+
+bool kalmanBench() {
+	// The left wheel reads v + w * track / 2, the right v - w * track / 2, the gyro w
+	const Filter::OutputMatrix H = {0, 0, 0, 1, TRACK / 2,
+	                                0, 0, 0, 1, -TRACK / 2,
+	                                0, 0, 0, 0, 1};
+	const double wheelNoise = 0.05, gyroNoise = 0.02, accelNoise = 0.5;
+	Filter kf(Filter::StateMatrix::identity(), Filter::InputMatrix(), H,
+	          Filter::StateMatrix::diagonal({1e-6, 1e-6, 1e-6, std::pow(accelNoise * DT, 2),
+	                                         std::pow(accelNoise * DT, 2)}),
+	          Filter::MeasurementMatrix::diagonal(
+	            {wheelNoise * wheelNoise, wheelNoise * wheelNoise, gyroNoise * gyroNoise}));
+
+	std::mt19937 rng(3);
+	std::normal_distribution<double> wheel(0, wheelNoise), gyro(0, gyroNoise),
+	  accel(0, accelNoise);
+
+#ifdef __arm__
+	const int steps = 20000;
+#else
+	const int steps = 200000;
+#endif
+	State truth;
+	Timing predictTime, updateTime, stepTime;
+	double filterError = 0, rawError = 0;
+	bool updated = true;
+#ifndef __arm__
+	const std::size_t allocationsBefore = allocations;
+#endif
+
+	for (int i = 0; i < steps; i++) {
+		const double t = i * DT;
+		const Input u = {1.5 * std::sin(t * 0.7), 3 * std::sin(t * 1.3)};
+		Input actual = u;
+		actual[0] += accel(rng);
+		actual[1] += accel(rng);
+		truth = model(truth, actual);
+
+		const double v = truth[3], w = truth[4];
+		const Measurement z = {v + w * TRACK / 2 + wheel(rng), v - w * TRACK / 2 + wheel(rng),
+		                       w + gyro(rng)};
+
+		const std::uint64_t start = nowNanos();
+		kf.predict(u, model, jacobian);
+		const std::uint64_t predicted = nowNanos();
+		updated &= kf.update(z);
+		const std::uint64_t end = nowNanos();
+
+		predictTime.add(predicted - start);
+		updateTime.add(end - predicted);
+		stepTime.add(end - start);
+
+		filterError += std::pow(kf.getState()[3] - v, 2);
+		rawError += std::pow((z[0] + z[1]) / 2 - v, 2);
+	}
+
+	std::printf("%-8s %10s %10s %9s\n", "", "mean ns", "worst ns", "of 10 ms");
+	report("predict", predictTime, steps);
+	report("update", updateTime, steps);
+	report("step", stepTime, steps);
+
+	filterError = std::sqrt(filterError / steps);
+	rawError = std::sqrt(rawError / steps);
+	std::printf("rms velocity error: filter %.4f m/s, raw wheels %.4f m/s\n", filterError,
+	            rawError);
+	bool ok = updated && filterError < rawError;
+
+#ifndef __arm__
+	const std::size_t stepAllocations = allocations - allocationsBefore;
+	std::printf("heap allocations in %d steps: %zu\n", steps, stepAllocations);
+	ok &= stepAllocations == 0;
+#endif
+	std::printf("%s\n", ok ? "ok" : "FAILED");
+	return ok;
+}
+
+#ifndef __arm__
+int main() {
+	return kalmanBench() ? 0 : 1;
+}
+#endif
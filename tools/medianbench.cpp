@@ -0,0 +1,123 @@
+/**
+ * \file medianbench.cpp
+ * Checks okapi::MedianFilter against the quickselect implementation it
+ * replaced and times both for window sizes from 5 to 255. Every output of the
+ * two must be identical on a noisy signal with repeated values and outliers.
+ * Exits with 1 if any differ.
+ *
+ * Build and run from the project root:
+ *   g++ -std=gnu++17 -O2 -Iinclude tools/medianbench.cpp -o medianbench
+ *   ./medianbench
+ */
+#include "okapi/api/filter/medianFilter.hpp"
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Filter's destructor is compiled into the okapilib archive, which is not linked here
+okapi::Filter::~Filter() = default;
+
+/**
+ * The previous MedianFilter: copy the window and quickselect the median (N. Wirth's algorithm,
+ * implementation by N. Devillard).
+ */
+template <std::size_t n> class QuickselectMedian {
+	public:
+	double filter(const double ireading) {
+		data[index++] = ireading;
+		if (index >= n)
+			index = 0;
+
+		std::array<double, n> copy = data;
+		std::size_t l = 0, m = n - 1;
+		while (l < m) {
+			const double x = copy[middle];
+			std::size_t i = l, j = m;
+			do {
+				while (copy[i] < x)
+					i++;
+				while (x < copy[j])
+					j--;
+				if (i <= j) {
+					std::swap(copy[i], copy[j]);
+					i++;
+					j--;
+				}
+			} while (i <= j);
+			if (j < middle)
+				l = i;
+			if (middle < i)
+				m = j;
+		}
+		return copy[middle];
+	}
+
+	private:
+	static constexpr std::size_t middle = (n & 1) ? n / 2 : n / 2 - 1;
+	std::array<double, n> data{0};
+	std::size_t index = 0;
+};
+
+static std::vector<double> makeSignal(std::size_t count) {
+	std::mt19937 rng(42);
+	std::normal_distribution<double> noise(0, 5);
+	std::uniform_int_distribution<int> event(0, 99);
+	std::vector<double> out;
+	out.reserve(count);
+	for (std::size_t i = 0; i < count; i++) {
+		double v = 100 * std::sin(i * 0.01) + noise(rng);
+		const int e = event(rng);
+		if (e < 3)
+			v = 1e4; // an outlier, like an ultrasonic miss
+		else if (e < 20)
+			v = std::round(v); // repeated values
+		out.push_back(v);
+	}
+	return out;
+}
+
+// Keeps the timed loops from being optimized away
+static volatile double sink;
+
+template <class F> static double nanosPerSample(F& filter, const std::vector<double>& signal) {
+	const auto start = std::chrono::steady_clock::now();
+	for (double v : signal)
+		sink = filter.filter(v);
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count() / signal.size();
+}
+
+template <std::size_t n> static bool run(const std::vector<double>& signal) {
+	okapi::MedianFilter<n> heap;
+	QuickselectMedian<n> quick;
+	std::size_t mismatches = 0;
+	for (double v : signal)
+		if (heap.filter(v) != quick.filter(v))
+			mismatches++;
+
+	okapi::MedianFilter<n> heapTimed;
+	QuickselectMedian<n> quickTimed;
+	const double heapNs = nanosPerSample(heapTimed, signal);
+	const double quickNs = nanosPerSample(quickTimed, signal);
+	std::printf("%5zu %14.1f %14.1f %8.1fx %10zu\n", n, quickNs, heapNs, quickNs / heapNs,
+	            mismatches);
+	return mismatches == 0;
+}
+
+int main() {
+	const auto signal = makeSignal(200000);
+	std::printf("%5s %14s %14s %9s %10s\n", "taps", "quickselect ns", "dual heap ns", "speedup",
+	            "mismatches");
+	bool ok = true;
+	ok &= run<5>(signal);
+	ok &= run<6>(signal);
+	ok &= run<15>(signal);
+	ok &= run<31>(signal);
+	ok &= run<64>(signal);
+	ok &= run<127>(signal);
+	ok &= run<255>(signal);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,142 @@
+/**
+ * \file odombench.cpp
+ * Replays synthetic S-curve drives through several odometry integrators and
+ * reports how far each ends up from the ground truth, next to its cost in
+ * nanoseconds per step. The integrators are:
+ *  - euler: move along the heading at the start of the step
+ *  - midpoint: move along the heading halfway through the step
+ *  - arc: arms::odom::arcStep in double precision (the default build)
+ *  - arc float: arms::odom::arcStep in single precision (ARMS_ODOM_FLOAT)
+ *
+ * The ground truth integrates the same wheel speeds with 1000 sub-steps per
+ * 10 ms tick. Each tick's wheel travel is what the encoders would read. No
+ * integrator can see how the speeds changed within a tick, so drives whose
+ * turn rate changes quickly leave an error floor shared by all of them.
+ *
+ * Build and run from the project root:
+ *   g++ -std=gnu++17 -O2 -Iinclude tools/odombench.cpp -o odombench
+ *   ./odombench
+ */
+#include "ARMS/odomMath.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+static const double DT = 0.01;
+static const double TRACK = 11.125;
+static const int SUBSTEPS = 1000;
+
+struct Tick {
+	double forward;
+	double dtheta;
+};
+
+struct Drive {
+	const char* name;
+	std::vector<Tick> ticks;
+	std::vector<arms::odom::OdomPose<double>> truth; // pose after each tick
+};
+
+/**
+ * Drive at a trapezoidal speed while the turn rate swings back and forth,
+ * tracing an S-curve. Everything is in inches, seconds and radians.
+ */
+static Drive makeDrive(const char* name, double speed, double turnRate,
+                       double period, double seconds) {
+	Drive d{name, {}, {}};
+	arms::odom::OdomPose<double> pose{0, 0, 0};
+	const double h = DT / SUBSTEPS;
+	const int ticks = int(seconds / DT);
+	for (int i = 0; i < ticks; i++) {
+		Tick tick{0, 0};
+		for (int j = 0; j < SUBSTEPS; j++) {
+			const double t = (i * SUBSTEPS + j + 0.5) * h;
+			const double ramp = std::fmin(1, std::fmin(t, seconds - t) / 0.5);
+			const double v = speed * ramp;
+			const double w = turnRate * ramp * std::sin(2 * M_PI * t / period);
+			// the wheels' travel for this sub-step
+			const double left = (v - w * TRACK / 2) * h;
+			const double right = (v + w * TRACK / 2) * h;
+			const double forward = (left + right) / 2;
+			const double dtheta = (right - left) / TRACK;
+			arms::odom::arcStep(pose, forward, 0.0, dtheta);
+			tick.forward += forward;
+			tick.dtheta += dtheta;
+		}
+		d.ticks.push_back(tick);
+		d.truth.push_back(pose);
+	}
+	return d;
+}
+
+template <typename T> static void euler(arms::odom::OdomPose<T>& p, const Tick& s) {
+	p.x += T(s.forward) * std::cos(p.theta);
+	p.y += T(s.forward) * std::sin(p.theta);
+	p.theta += T(s.dtheta);
+}
+
+template <typename T> static void midpoint(arms::odom::OdomPose<T>& p, const Tick& s) {
+	const T a = p.theta + T(s.dtheta) / 2;
+	p.x += T(s.forward) * std::cos(a);
+	p.y += T(s.forward) * std::sin(a);
+	p.theta += T(s.dtheta);
+}
+
+template <typename T> static void arc(arms::odom::OdomPose<T>& p, const Tick& s) {
+	arms::odom::arcStep(p, T(s.forward), T(0), T(s.dtheta));
+}
+
+// Keeps the timed loops from being optimized away
+static volatile double sink;
+
+template <typename T, typename Step>
+static void run(const char* name, Step step, const std::vector<Drive>& drives) {
+	std::printf("%-10s", name);
+	std::size_t steps = 0;
+	for (const Drive& d : drives) {
+		arms::odom::OdomPose<T> p{0, 0, 0};
+		double worst = 0;
+		for (std::size_t i = 0; i < d.ticks.size(); i++) {
+			step(p, d.ticks[i]);
+			worst = std::fmax(worst, std::hypot(double(p.x) - d.truth[i].x,
+			                                    double(p.y) - d.truth[i].y));
+		}
+		std::printf(" %12.2e", worst);
+		steps += d.ticks.size();
+	}
+
+	const int reps = 200;
+	const auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < reps; r++) {
+		for (const Drive& d : drives) {
+			arms::odom::OdomPose<T> p{0, 0, 0};
+			for (const Tick& t : d.ticks)
+				step(p, t);
+			sink = double(p.x);
+		}
+	}
+	const auto end = std::chrono::steady_clock::now();
+	std::printf(" %10.2f\n",
+	            std::chrono::duration<double, std::nano>(end - start).count() /
+	                (double(reps) * steps));
+}
+
+int main() {
+	std::vector<Drive> drives;
+	drives.push_back(makeDrive("gentle", 30, 1.0, 4, 4));
+	drives.push_back(makeDrive("sweeping", 50, 8.0, 6, 3));
+	drives.push_back(makeDrive("wiggle", 45, 4.0, 1, 4));
+
+	std::printf("max position error over the drive (in), and cost\n");
+	std::printf("%-10s", "");
+	for (const Drive& d : drives)
+		std::printf(" %12s", d.name);
+	std::printf(" %10s\n", "ns/step");
+
+	run<double>("euler", euler<double>, drives);
+	run<double>("midpoint", midpoint<double>, drives);
+	run<double>("arc", arc<double>, drives);
+	run<float>("arc float", arc<float>, drives);
+	return 0;
+}
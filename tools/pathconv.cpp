@@ -0,0 +1,102 @@
+/**
+ * \file pathconv.cpp
+ * Converts a path CSV written by AsyncMotionProfileController::storePath into
+ * the binary format read by loadPathBinary, then reports the size of both
+ * files, how long each takes to load on this computer and the largest error
+ * introduced by quantizing each column.
+ *
+ * Build against a host build of the squiggles sources that ship with okapilib,
+ * then run from the project root:
+ *   g++ -std=gnu++17 -O2 -Iinclude -iquote include/okapi/squiggles \
+ *       tools/pathconv.cpp <squiggles sources> -o pathconv
+ *   ./pathconv path.csv path.bin
+ */
+#include "squiggles.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+template <typename Load> static double timeLoad(Load load) {
+	const int runs = 50;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < runs; i++)
+		load();
+	std::chrono::duration<double, std::micro> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	return elapsed.count() / runs;
+}
+
+static long fileSize(const char* name) {
+	std::FILE* f = std::fopen(name, "rb");
+	if (f == nullptr)
+		return -1;
+	std::fseek(f, 0, SEEK_END);
+	long size = std::ftell(f);
+	std::fclose(f);
+	return size;
+}
+
+int main(int argc, char** argv) {
+	if (argc != 3) {
+		std::fprintf(stderr, "usage: %s <in.csv> <out.bin>\n", argv[0]);
+		return 1;
+	}
+
+	std::ifstream csv(argv[1]);
+	auto path = squiggles::deserialize_path(csv);
+	if (!path) {
+		std::fprintf(stderr, "%s is not a valid path CSV\n", argv[1]);
+		return 1;
+	}
+
+	std::FILE* out = std::fopen(argv[2], "wb");
+	if (out == nullptr || squiggles::serialize_binary_path(out, *path) != 0) {
+		std::fprintf(stderr, "could not write %s\n", argv[2]);
+		return 1;
+	}
+	std::fclose(out);
+
+	std::FILE* in = std::fopen(argv[2], "rb");
+	auto loaded = squiggles::deserialize_binary_path(in);
+	std::fclose(in);
+	if (!loaded || loaded->size() != path->size()) {
+		std::fprintf(stderr, "%s did not read back\n", argv[2]);
+		return 1;
+	}
+
+	const char* columns[] = {"x",     "y",         "yaw",  "vel",   "accel",
+	                         "jerk",  "curvature", "time", "wheel0", "wheel1",
+	                         "wheel2", "wheel3"};
+	std::size_t count = squiggles::BinaryPathHeader::BASE_COLUMNS +
+	                    std::min((*path)[0].wheel_velocities.size(),
+	                             squiggles::BinaryPathHeader::MAX_WHEELS);
+	for (std::size_t c = 0; c < count; c++) {
+		double error = 0;
+		for (std::size_t i = 0; i < path->size(); i++) {
+			error = std::max(error,
+			                 std::fabs(squiggles::detail::column_value((*path)[i], c) -
+			                           squiggles::detail::column_value((*loaded)[i], c)));
+		}
+		std::printf("%-10s max error %g\n", columns[c], error);
+	}
+
+	double csvTime = timeLoad([&] {
+		std::ifstream f(argv[1]);
+		return squiggles::deserialize_path(f);
+	});
+	double binTime = timeLoad([&] {
+		std::FILE* f = std::fopen(argv[2], "rb");
+		auto p = squiggles::deserialize_binary_path(f);
+		std::fclose(f);
+		return p;
+	});
+
+	std::printf("%zu points\n", path->size());
+	std::printf("csv:    %8ld bytes, %10.1f us to load\n", fileSize(argv[1]),
+	            csvTime);
+	std::printf("binary: %8ld bytes, %10.1f us to load\n", fileSize(argv[2]),
+	            binTime);
+	return 0;
+}
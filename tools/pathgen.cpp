@@ -0,0 +1,134 @@
+/**
+ * \file pathgen.cpp
+ * Runs the squiggles generator on a computer for every path in
+ * tools/paths.def and prints a header of read-only profile tables, so the
+ * robot never has to generate those paths during initialize().
+ *
+ * Build against a host build of the squiggles sources that ship with okapilib,
+ * then run from the project root:
+ *   g++ -std=gnu++17 -O2 -Iinclude -iquote include/okapi/squiggles \
+ *       tools/pathgen.cpp <squiggles sources> -o pathgen
+ *   ./pathgen > include/generatedPaths.h
+ *
+ * Or let the Makefile do both by setting SQUIGGLES_SRC to those sources. The
+ * header records the POSIX cksum of the manifest it was generated from, and
+ * the Makefile stops the robot build if that no longer matches tools/paths.def.
+ *
+ * The output only depends on the manifest, so regenerating an unchanged
+ * manifest gives a byte-identical header. If any path can't be generated, or
+ * has more wheels than a PackedProfilePoint stores, nothing is printed and
+ * pathgen exits with an error.
+ */
+#include "squiggles.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct Generated {
+	const char* name;
+	std::vector<squiggles::ProfilePoint> path;
+};
+
+/**
+ * The checksum printed by the POSIX cksum utility, and the file's size
+ */
+static bool cksum(const char* file, std::uint32_t& crc, std::uint64_t& size) {
+	std::FILE* in = std::fopen(file, "rb");
+	if (in == nullptr)
+		return false;
+	crc = 0;
+	size = 0;
+	auto add = [&crc](unsigned char byte) {
+		crc ^= std::uint32_t(byte) << 24;
+		for (int bit = 0; bit < 8; bit++)
+			crc = crc & 0x80000000u ? (crc << 1) ^ 0x04c11db7u : crc << 1;
+	};
+	for (int c; (c = std::fgetc(in)) != EOF; size++)
+		add(static_cast<unsigned char>(c));
+	std::fclose(in);
+	for (std::uint64_t n = size; n != 0; n >>= 8)
+		add(static_cast<unsigned char>(n & 0xff));
+	crc = ~crc;
+	return true;
+}
+
+// Unused while the manifest is empty
+[[maybe_unused]] static Generated generate(const char* name, double track_width,
+                                          double max_vel, double max_accel,
+                                          double max_jerk,
+                                          std::vector<squiggles::Pose> waypoints) {
+	squiggles::Constraints constraints(max_vel, max_accel, max_jerk);
+	squiggles::SplineGenerator generator(
+	    constraints,
+	    std::make_shared<squiggles::TankModel>(track_width, constraints),
+	    0.01);
+	return {name, generator.generate(waypoints)};
+}
+
+static void emit(const Generated& generated) {
+	const char* name = generated.name;
+	printf("\ninline constexpr squiggles::PackedProfilePoint %s_points[] = {\n",
+	       name);
+	for (const auto& point : generated.path) {
+		auto p = squiggles::PackedProfilePoint::pack(point);
+		printf("  {%.9g, %.9g, %.9g, %.9g, %.9g, %.9g, %.9g, %.9g, {", p.x, p.y,
+		       p.yaw, p.vel, p.accel, p.jerk, p.curvature, p.time);
+		for (std::size_t i = 0; i < squiggles::PackedProfilePoint::MAX_WHEELS;
+		     ++i) {
+			printf(i ? ", %.9g" : "%.9g", p.wheel_velocities[i]);
+		}
+		printf("}},\n");
+	}
+	printf("};\n");
+	printf("inline constexpr squiggles::PackedPath %s{%s_points, %zu, %zu};\n",
+	       name, name, generated.path.size(),
+	       generated.path[0].wheel_velocities.size());
+}
+
+int main() {
+	std::uint32_t crc;
+	std::uint64_t size;
+	if (!cksum("tools/paths.def", crc, size)) {
+		fprintf(stderr, "pathgen: can't read tools/paths.def, run pathgen from "
+		                "the project root\n");
+		return 1;
+	}
+
+	std::vector<Generated> paths;
+#define PATH(name, track_width, max_vel, max_accel, max_jerk, ...)             \
+	paths.push_back(                                                           \
+	    generate(#name, track_width, max_vel, max_accel, max_jerk, {__VA_ARGS__}));
+#include "paths.def"
+#undef PATH
+
+	bool failed = false;
+	for (const Generated& generated : paths) {
+		if (generated.path.empty()) {
+			fprintf(stderr, "pathgen: no path could be generated for %s\n",
+			        generated.name);
+			failed = true;
+		} else if (generated.path[0].wheel_velocities.size() >
+		           squiggles::PackedProfilePoint::MAX_WHEELS) {
+			fprintf(stderr,
+			        "pathgen: %s has %zu wheels, but packed paths store at "
+			        "most %zu\n",
+			        generated.name, generated.path[0].wheel_velocities.size(),
+			        squiggles::PackedProfilePoint::MAX_WHEELS);
+			failed = true;
+		}
+	}
+	if (failed)
+		return 1;
+
+	printf("// Generated by tools/pathgen.cpp from tools/paths.def. Do not edit.\n");
+	printf("// tools/paths.def cksum %lu %llu\n", static_cast<unsigned long>(crc),
+	       static_cast<unsigned long long>(size));
+	printf("#pragma once\n\n");
+	printf("#include \"okapi/squiggles/geometry/packedprofile.hpp\"\n\n");
+	printf("namespace paths {\n");
+	for (const Generated& generated : paths)
+		emit(generated);
+	printf("} // namespace paths\n");
+}
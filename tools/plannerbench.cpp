@@ -0,0 +1,132 @@
+/**
+ * \file plannerbench.cpp
+ * Times squiggles::GridPlanner on a few representative field layouts: an
+ * empty field, a center barrier, goal posts around the field, and a cluttered
+ * skills field. For each layout it plans a set of start/goal pairs and
+ * reports the time spent in the grid search alone and in the whole plan
+ * (search, shortcutting and spline smoothing), along with the number of
+ * waypoints left after shortcutting and the profile's duration. Each layout
+ * ends with its mean search and plan times and how many queries were planned.
+ *
+ * Build against a host build of the squiggles sources that ship with okapilib,
+ * then run from the project root:
+ *   g++ -std=gnu++17 -O2 -Iinclude -iquote include/okapi/squiggles \
+ *       tools/plannerbench.cpp <squiggles sources> -o plannerbench
+ *   ./plannerbench [cell size in meters, default 0.05]
+ */
+#include "squiggles.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+using squiggles::GridPlanner;
+using squiggles::OccupancyGrid;
+using squiggles::Pose;
+
+// A 12 foot field
+static const double FIELD = 3.6576;
+static const double ROBOT_RADIUS = 0.23;
+
+struct Layout {
+	const char* name;
+	std::function<void(OccupancyGrid&)> build;
+};
+
+struct Query {
+	Pose start;
+	Pose goal;
+};
+
+static const Layout layouts[] = {
+  {"empty", [](OccupancyGrid&) {}},
+  {"center barrier",
+   [](OccupancyGrid& g) {
+	   g.add_rectangle(FIELD / 2 - 0.03, 0.6, FIELD / 2 + 0.03, FIELD - 0.6);
+   }},
+  {"goal posts",
+   [](OccupancyGrid& g) {
+	   for (double x : {1.0, FIELD - 1.0})
+		   for (double y : {1.0, FIELD - 1.0})
+			   g.add_circle(x, y, 0.15);
+	   g.add_circle(FIELD / 2, FIELD / 2, 0.15);
+   }},
+  {"skills clutter",
+   [](OccupancyGrid& g) {
+	   g.add_rectangle(FIELD / 2 - 0.03, 0.9, FIELD / 2 + 0.03, FIELD - 0.9);
+	   g.add_rectangle(0.9, FIELD / 2 - 0.03, FIELD - 0.9, FIELD / 2 + 0.03);
+	   g.add_rectangle(0.75, 0.75, 1.0, 1.0);
+	   g.add_rectangle(FIELD - 1.0, FIELD - 1.0, FIELD - 0.75, FIELD - 0.75);
+	   g.add_circle(FIELD - 0.9, 0.9, 0.2);
+	   g.add_circle(0.9, FIELD - 0.9, 0.2);
+	   g.add_circle(FIELD / 2, 0.35, 0.1);
+	   g.add_circle(FIELD / 2, FIELD - 0.35, 0.1);
+   }},
+};
+
+static const Query queries[] = {
+  {Pose(0.4, 0.4, 0), Pose(FIELD - 0.4, FIELD - 0.4, M_PI / 2)},
+  {Pose(0.4, FIELD / 2, 0), Pose(FIELD - 0.4, FIELD / 2, 0)},
+  {Pose(FIELD - 0.4, 0.4, M_PI), Pose(0.4, FIELD - 0.6, M_PI / 2)},
+  {Pose(0.5, 1.4, M_PI / 2), Pose(2.2, 1.4, -M_PI / 2)},
+};
+
+template <class F> static double millis(F&& f) {
+	auto start = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+	  .count();
+}
+
+int main(int argc, char** argv) {
+	const double resolution = argc > 1 ? std::atof(argv[1]) : 0.05;
+	squiggles::Constraints constraints(1.2, 2.5, 10.0);
+	squiggles::SplineGenerator generator(
+	  constraints, std::make_shared<squiggles::TankModel>(0.3, constraints), 0.01);
+
+	std::printf("cell size %.3f m\n", resolution);
+	std::printf("%-16s %5s %10s %10s %9s %9s\n", "layout", "query", "search ms", "plan ms",
+	            "waypoints", "time s");
+	for (const Layout& layout : layouts) {
+		OccupancyGrid field(FIELD, FIELD, resolution);
+		layout.build(field);
+		GridPlanner planner(field.inflated(ROBOT_RADIUS));
+
+		int q = 0;
+		int planned = 0;
+		double searchTotal = 0;
+		double planTotal = 0;
+		for (const Query& query : queries) {
+			q++;
+			// The first search sizes the planner's buffers; time the later ones
+			planner.search(query.start.x, query.start.y, query.goal.x, query.goal.y);
+			std::optional<std::vector<Pose>> route;
+			double search = millis([&] {
+				route = planner.search(query.start.x, query.start.y, query.goal.x,
+				                       query.goal.y);
+			});
+
+			std::optional<std::vector<squiggles::ProfilePoint>> profile;
+			double plan = millis([&] { profile = planner.plan(query.start, query.goal, generator); });
+			searchTotal += search;
+			planTotal += plan;
+
+			if (!route || !profile) {
+				std::printf("%-16s %5d %10.3f %10.3f %9s %9s\n", layout.name, q, search, plan, "-",
+				            route ? "no spline" : "no route");
+				continue;
+			}
+			planned++;
+			std::printf("%-16s %5d %10.3f %10.3f %9zu %9.2f\n", layout.name, q, search, plan,
+			            planner.shortcut(*route).size(),
+			            profile->back().time - profile->front().time);
+		}
+		std::printf("%-16s %5s %10.3f %10.3f %6d of %d planned\n", layout.name, "mean",
+		            searchTotal / q, planTotal / q, planned, q);
+	}
+	return 0;
+}
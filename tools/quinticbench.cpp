@@ -0,0 +1,118 @@
+/**
+ * \file quinticbench.cpp
+ * Times evaluating an x and y QuinticPolynomial with all three derivatives,
+ * one call per value as the generator does today, against calc_batch and
+ * calc_batch_xy. Run it on each target to compare; on the V5 (Cortex-A9,
+ * no double precision vector unit) the vector version compiles to scalar
+ * code and the gain comes from sharing work between the calls.
+ *
+ * Before timing, checks that calc_batch and calc_batch_xy give bit-identical
+ * samples, and that both agree with calc_point and the derivative functions
+ * to within rounding. Exits with 1 if a check fails.
+ *
+ * Build against a host build of the squiggles sources that ship with okapilib,
+ * then run from the project root:
+ *   g++ -std=gnu++17 -O2 -Iinclude -iquote include/okapi/squiggles \
+ *       tools/quinticbench.cpp <squiggles sources> -o quinticbench
+ *   ./quinticbench
+ */
+#include "squiggles.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using squiggles::QuinticPolynomial;
+
+template <typename Run> static double nsPerSample(Run run, std::size_t samples) {
+	const int reps = 200;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < reps; i++)
+		run();
+	std::chrono::duration<double, std::nano> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	return elapsed.count() / (reps * samples);
+}
+
+/**
+ * The largest difference between the batch samples and one call per value,
+ * relative to the largest magnitude of each value over the curve.
+ */
+static double worstError(QuinticPolynomial& poly, const std::vector<double>& t,
+                         const std::vector<QuinticPolynomial::Sample>& batch) {
+	double scale[4] = {0, 0, 0, 0};
+	double error[4] = {0, 0, 0, 0};
+	for (std::size_t i = 0; i < t.size(); i++) {
+		const double expected[] = {poly.calc_point(t[i]), poly.calc_first_derivative(t[i]),
+		                           poly.calc_second_derivative(t[i]),
+		                           poly.calc_third_derivative(t[i])};
+		const double actual[] = {batch[i].p, batch[i].v, batch[i].a, batch[i].j};
+		for (int k = 0; k < 4; k++) {
+			scale[k] = std::max(scale[k], std::fabs(expected[k]));
+			error[k] = std::max(error[k], std::fabs(actual[k] - expected[k]));
+		}
+	}
+	double worst = 0;
+	for (int k = 0; k < 4; k++)
+		worst = std::max(worst, scale[k] > 0 ? error[k] / scale[k] : error[k]);
+	return worst;
+}
+
+int main() {
+	QuinticPolynomial x(0, 1, 0, 1.2, 1, 0, 4);
+	QuinticPolynomial y(0, 0, 0, 0.6, 0.5, 0, 4);
+
+	const std::size_t n = 4000;
+	std::vector<double> t(n);
+	for (std::size_t i = 0; i < n; i++)
+		t[i] = 4.0 * i / (n - 1);
+	std::vector<QuinticPolynomial::Sample> sx(n), sy(n);
+
+	std::vector<QuinticPolynomial::Sample> bx(n), by(n);
+	x.calc_batch(t.data(), n, bx.data());
+	y.calc_batch(t.data(), n, by.data());
+	QuinticPolynomial::calc_batch_xy(x, y, t.data(), n, sx.data(), sy.data());
+	const bool identical =
+	    std::memcmp(bx.data(), sx.data(), n * sizeof(QuinticPolynomial::Sample)) == 0 &&
+	    std::memcmp(by.data(), sy.data(), n * sizeof(QuinticPolynomial::Sample)) == 0;
+	const double error = std::max(worstError(x, t, bx), worstError(y, t, by));
+	const bool ok = identical && error < 1e-12;
+	std::printf("calc_batch and calc_batch_xy %s, largest relative difference from "
+	            "one call per value %.2g  %s\n",
+	            identical ? "identical" : "DIFFER", error, ok ? "ok" : "FAIL");
+
+	volatile double sink = 0;
+	double scalar = nsPerSample(
+	    [&] {
+		    double sum = 0;
+		    for (std::size_t i = 0; i < n; i++) {
+			    sum += x.calc_point(t[i]) + x.calc_first_derivative(t[i]) +
+			           x.calc_second_derivative(t[i]) + x.calc_third_derivative(t[i]) +
+			           y.calc_point(t[i]) + y.calc_first_derivative(t[i]) +
+			           y.calc_second_derivative(t[i]) + y.calc_third_derivative(t[i]);
+		    }
+		    sink = sum;
+	    },
+	    n);
+	double batch = nsPerSample(
+	    [&] {
+		    x.calc_batch(t.data(), n, sx.data());
+		    y.calc_batch(t.data(), n, sy.data());
+		    sink = sx[n / 2].p + sy[n / 2].p;
+	    },
+	    n);
+	double vector = nsPerSample(
+	    [&] {
+		    QuinticPolynomial::calc_batch_xy(x, y, t.data(), n, sx.data(), sy.data());
+		    sink = sx[n / 2].p + sy[n / 2].p;
+	    },
+	    n);
+
+	std::printf("per (x, y) sample with three derivatives:\n");
+	std::printf("  one call per value  %7.2f ns\n", scalar);
+	std::printf("  calc_batch          %7.2f ns  x%.2f\n", batch, scalar / batch);
+	std::printf("  calc_batch_xy       %7.2f ns  x%.2f\n", vector, scalar / vector);
+	return ok ? 0 : 1;
+}
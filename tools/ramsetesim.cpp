@@ -0,0 +1,113 @@
+/**
+ * \file ramsetesim.cpp
+ * Host simulation of AsyncRamseteMotionProfileController's tracking. An S-curve generated by
+ * squiggles::SplineGenerator with a TankModel, as AsyncMotionProfileController generates its
+ * paths, is followed by a simulated differential drive with motor lag, wheel slip on one side and
+ * a bump partway through. It is followed once open loop and once with the RAMSETE correction,
+ * forwards, backwards and mirrored. For each run it reports the largest and final distance from
+ * the path.
+ *
+ * The simulated robot turns like the profile's wheel velocities: a faster right side turns it
+ * from +x towards +y. Besides the generator, only the controller's side-effect free
+ * `okapi::ramseteStep()` is used, so no robot or okapilib archive is needed. Build against a host
+ * build of the squiggles sources that ship with okapilib, then run from the project root:
+ *   g++ -std=gnu++17 -O2 -Iinclude -iquote include/okapi/squiggles tools/ramsetesim.cpp \
+ *       <squiggles sources> -o ramsetesim
+ *   ./ramsetesim
+ */
+#include "okapi/api/control/util/ramsete.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using squiggles::Pose;
+using squiggles::ProfilePoint;
+
+static const double DT = 0.01;
+static const double TRACK = 0.3;
+
+/**
+ * An S-curve to the left and back, 2.4 m long
+ */
+static std::vector<ProfilePoint> makeProfile() {
+	squiggles::Constraints constraints(1.0, 2.0, 10.0);
+	squiggles::SplineGenerator generator(
+	  constraints, std::make_shared<squiggles::TankModel>(TRACK, constraints), DT);
+	return generator.generate({Pose(0, 0, 0), Pose(1.2, 0.6, 0), Pose(2.4, 0, 0)});
+}
+
+struct Result {
+	double maxError;
+	double finalError;
+};
+
+static Result run(const std::vector<ProfilePoint>& path, bool closedLoop, int reversed,
+                  bool mirrored, bool disturbed) {
+	Pose robot(0, 0, 0);
+	double left = 0, right = 0;
+	const double lag = disturbed ? 0.05 : 0;
+	const double slip = disturbed ? 0.95 : 1;
+
+	Result result{0, 0};
+	for (std::size_t i = 0; i < path.size(); i++) {
+		const auto step = okapi::ramseteStep(
+		  path[i], path.front().vector.pose, Pose(0, 0, 0), robot, reversed, mirrored, TRACK,
+		  okapi::RamseteGains());
+		double leftCmd = step.leftVel, rightCmd = step.rightVel;
+		if (!closedLoop) {
+			leftCmd = path[i].wheel_velocities[mirrored ? 1 : 0] * reversed;
+			rightCmd = path[i].wheel_velocities[mirrored ? 0 : 1] * reversed;
+		}
+		result.maxError = std::max(result.maxError, std::hypot(step.error.x, step.error.y));
+
+		const double alpha = lag > 0 ? DT / (lag + DT) : 1;
+		left += (leftCmd - left) * alpha;
+		right += (rightCmd - right) * alpha;
+		const double v = (left + right * slip) / 2;
+		const double w = (right * slip - left) / TRACK;
+		robot.x += v * DT * std::cos(robot.yaw + w * DT / 2);
+		robot.y += v * DT * std::sin(robot.yaw + w * DT / 2);
+		robot.yaw += w * DT;
+
+		if (disturbed && i == static_cast<std::size_t>(1.0 / DT)) {
+			robot.y += 0.05;
+			robot.yaw += 0.15;
+		}
+	}
+
+	const auto last = okapi::ramseteStep(
+	  path.back(), path.front().vector.pose, Pose(0, 0, 0), robot, reversed, mirrored, TRACK,
+	  okapi::RamseteGains());
+	result.finalError = std::hypot(last.error.x, last.error.y);
+	return result;
+}
+
+int main() {
+	const auto path = makeProfile();
+	if (path.empty()) {
+		std::fprintf(stderr, "ramsetesim: the generator returned no path\n");
+		return 1;
+	}
+	std::printf("profile: %zu points, %.2f s\n", path.size(), path.back().time);
+	std::printf("%-10s %-10s %-11s %10s %10s\n", "direction", "disturbed", "mode", "max err m",
+	            "final err m");
+
+	const struct {
+		const char* name;
+		int reversed;
+		bool mirrored;
+	} directions[] = {{"forwards", 1, false}, {"backwards", -1, false}, {"mirrored", 1, true}};
+
+	for (const auto& d : directions) {
+		for (bool disturbed : {false, true}) {
+			for (bool closedLoop : {false, true}) {
+				const Result r = run(path, closedLoop, d.reversed, d.mirrored, disturbed);
+				std::printf("%-10s %-10s %-11s %10.4f %10.4f\n", d.name, disturbed ? "yes" : "no",
+				            closedLoop ? "closed loop" : "open loop", r.maxError, r.finalError);
+			}
+		}
+	}
+	return 0;
+}
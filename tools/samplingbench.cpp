@@ -0,0 +1,98 @@
+/**
+ * \file samplingbench.cpp
+ * Compares the fixed-step SplineGenerator with AdaptiveSplineGenerator on a
+ * few representative field paths. For each it reports the number of raw
+ * samples, the generation time, and the tracking error: how far a robot that
+ * follows the profile's velocity and curvature exactly ends up from the
+ * profile's own poses.
+ *
+ * Build against a host build of the squiggles sources that ship with okapilib,
+ * then run from the project root:
+ *   g++ -std=gnu++17 -O2 -Iinclude -iquote include/okapi/squiggles \
+ *       tools/samplingbench.cpp <squiggles sources> -o samplingbench
+ *   ./samplingbench
+ */
+#include "squiggles.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+using squiggles::Pose;
+using squiggles::ProfilePoint;
+
+static double trackingError(const std::vector<ProfilePoint>& path) {
+	if (path.empty())
+		return 0;
+	double x = path[0].vector.pose.x;
+	double y = path[0].vector.pose.y;
+	double yaw = path[0].vector.pose.yaw;
+	double error = 0;
+	for (std::size_t i = 1; i < path.size(); i++) {
+		const ProfilePoint& p = path[i - 1];
+		double dt = path[i].time - p.time;
+		double ds = p.vector.vel * dt;
+		double dyaw = ds * p.curvature;
+		x += ds * std::cos(yaw + dyaw / 2);
+		y += ds * std::sin(yaw + dyaw / 2);
+		yaw += dyaw;
+		error = std::max(error, std::hypot(x - path[i].vector.pose.x,
+		                                   y - path[i].vector.pose.y));
+	}
+	return error;
+}
+
+template <typename Generate> static double timeMs(Generate generate) {
+	auto start = std::chrono::steady_clock::now();
+	generate();
+	std::chrono::duration<double, std::milli> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+int main() {
+	struct Case {
+		const char* name;
+		std::vector<Pose> waypoints;
+	};
+	std::vector<Case> cases{
+	    {"straight", {Pose(0, 0, 0), Pose(2.5, 0, 0)}},
+	    {"s-curve", {Pose(0, 0, 0), Pose(1.2, 0.6, 0), Pose(2.4, 0, 0)}},
+	    {"tight turn", {Pose(0, 0, 0), Pose(0.6, 0.6, 1.57)}},
+	    {"skills",
+	     {Pose(0, 0, 0), Pose(1, 0.3, 0.5), Pose(1.8, 1.2, 1.57),
+	      Pose(1.2, 2, 3.14), Pose(0.3, 2.4, 2.5), Pose(-0.3, 3, 1.57)}},
+	};
+
+	squiggles::Constraints constraints(1.0, 2.0, 10.0);
+	auto model = std::make_shared<squiggles::TankModel>(0.3, constraints);
+	squiggles::SplineGenerator fixed(constraints, model, 0.01);
+	squiggles::AdaptiveSplineGenerator adaptive(constraints, model, 0.01);
+
+	std::printf("%-11s %-9s %8s %10s %12s\n", "path", "sampler", "samples",
+	            "time (ms)", "error (m)");
+	for (auto& c : cases) {
+		std::size_t fixedSamples = 0;
+		std::size_t adaptiveSamples = 0;
+		for (std::size_t i = 0; i + 1 < c.waypoints.size(); i++) {
+			squiggles::ControlVector s(c.waypoints[i]);
+			squiggles::ControlVector e(c.waypoints[i + 1]);
+			fixedSamples += fixed.gen_raw_path(s, e, false).size();
+			adaptiveSamples += adaptive
+			                       .gen_adaptive_raw_path(c.waypoints[i],
+			                                              c.waypoints[i + 1])
+			                       .size();
+		}
+
+		std::vector<ProfilePoint> a, b;
+		double fixedTime = timeMs([&] { a = fixed.generate(c.waypoints); });
+		double adaptiveTime =
+		    timeMs([&] { b = adaptive.generate_adaptive(c.waypoints); });
+
+		std::printf("%-11s %-9s %8zu %10.2f %12.5f\n", c.name, "fixed",
+		            fixedSamples, fixedTime, trackingError(a));
+		std::printf("%-11s %-9s %8zu %10.2f %12.5f\n", c.name, "adaptive",
+		            adaptiveSamples, adaptiveTime, trackingError(b));
+	}
+	return 0;
+}
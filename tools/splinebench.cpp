@@ -0,0 +1,91 @@
+/**
+ * \file splinebench.cpp
+ * Times ParallelSplineGenerator on a long multi-waypoint path with 1 to N
+ * worker threads against SplineGenerator::generate, and checks that every run
+ * matches generate's path bit for bit. Both search modes are run: the full
+ * search, where the segments are independent, and fast mode, where each
+ * segment writes the velocity it settled on into the waypoint it shares with
+ * the next one, so the segments must be searched one after another.
+ *
+ * Build against a host build of the squiggles sources that ship with okapilib,
+ * then run from the project root:
+ *   g++ -std=gnu++17 -O2 -DTHREADS_STD -pthread -Iinclude \
+ *       -iquote include/okapi/squiggles tools/splinebench.cpp \
+ *       <squiggles sources> -o splinebench
+ *   ./splinebench [waypoints] [most threads, default one per hardware thread]
+ */
+#include "squiggles.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+static bool identical(const std::vector<squiggles::ProfilePoint>& a,
+                      const std::vector<squiggles::ProfilePoint>& b) {
+	if (a.size() != b.size())
+		return false;
+	for (std::size_t i = 0; i < a.size(); i++) {
+		const double lhs[] = {a[i].vector.pose.x, a[i].vector.pose.y,
+		                      a[i].vector.pose.yaw, a[i].vector.vel,
+		                      a[i].vector.accel, a[i].vector.jerk,
+		                      a[i].curvature, a[i].time};
+		const double rhs[] = {b[i].vector.pose.x, b[i].vector.pose.y,
+		                      b[i].vector.pose.yaw, b[i].vector.vel,
+		                      b[i].vector.accel, b[i].vector.jerk,
+		                      b[i].curvature, b[i].time};
+		if (std::memcmp(lhs, rhs, sizeof(lhs)) != 0 ||
+		    a[i].wheel_velocities != b[i].wheel_velocities)
+			return false;
+	}
+	return true;
+}
+
+template <class F> static double millis(F&& f) {
+	const auto start = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+	    .count();
+}
+
+static bool run(const std::vector<squiggles::Pose>& waypoints, unsigned maxThreads, bool fast) {
+	squiggles::Constraints constraints(1.0, 2.0, 10.0);
+	auto model = std::make_shared<squiggles::TankModel>(0.3, constraints);
+
+	squiggles::SplineGenerator serial(constraints, model, 0.01);
+	std::vector<squiggles::ProfilePoint> reference;
+	const double base = millis([&] { reference = serial.generate(waypoints, fast); });
+	std::printf("%s search, %zu points\n", fast ? "fast" : "full", reference.size());
+	std::printf("  generate   %9.2f ms\n", base);
+
+	bool ok = !reference.empty();
+	for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+		squiggles::ParallelSplineGenerator generator(constraints, model, 0.01, threads);
+		std::vector<squiggles::ProfilePoint> path;
+		const double elapsed = millis([&] { path = generator.generate_parallel(waypoints, fast); });
+		const bool same = identical(path, reference);
+		ok = ok && same;
+		std::printf("  %2u threads %9.2f ms  x%.2f  %s\n", threads, elapsed, base / elapsed,
+		            same ? "identical" : "MISMATCH");
+	}
+	return ok;
+}
+
+int main(int argc, char** argv) {
+	std::size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 24;
+	unsigned maxThreads = argc > 2 ? std::strtoul(argv[2], nullptr, 10)
+	                               : std::max(1u, std::thread::hardware_concurrency());
+
+	// a skills-style path weaving across the field
+	std::vector<squiggles::Pose> waypoints;
+	for (std::size_t i = 0; i < count; i++) {
+		double x = 0.5 * i;
+		waypoints.emplace_back(x, i % 2 ? 0.6 : -0.6, i % 2 ? 0.5 : -0.5);
+	}
+	std::printf("%zu waypoints\n", count);
+
+	bool ok = run(waypoints, maxThreads, false);
+	ok &= run(waypoints, maxThreads, true);
+	return ok ? 0 : 1;
+}